@@ -5,9 +5,13 @@
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/base64url.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
+#include "base/task/post_task.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/network_constants.h"
 #include "brave/common/shield_exceptions.h"
@@ -18,6 +22,7 @@
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/grit/brave_generated_resources.h"
+#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "extensions/common/url_pattern.h"
 #include "ui/base/resource/resource_bundle.h"
@@ -35,6 +40,11 @@ namespace {
         kEmptyImageDataURI : kEmptyDataURI);
   }
 
+  // A batch is sent to the shields task runner once it holds this many
+  // requests, or when the latency cap expires.
+  const size_t kMaxAdBlockTPBatchSize = 64;
+  const int64_t kDefaultAdBlockTPBatchLatencyCapMs = 2;
+
 }  // namespace
 
 namespace brave {
@@ -113,6 +123,14 @@ void OnBeforeURLRequestAdBlockTPOnTaskRunner(std::shared_ptr<BraveRequestInfo> c
   }
 }
 
+void OnBeforeURLRequestAdBlockTPBatchOnTaskRunner(
+    const AdBlockTPMatchCallback& match_callback,
+    const std::vector<std::shared_ptr<BraveRequestInfo>>& ctxs) {
+  for (const auto& ctx : ctxs) {
+    match_callback.Run(ctx);
+  }
+}
+
 void OnBeforeURLRequestDispatchOnIOThread(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx) {
@@ -133,6 +151,133 @@ void OnBeforeURLRequestDispatchOnIOThread(
   next_callback.Run();
 }
 
+// Coalesces ad-block / tracking protection match requests on the IO thread
+// so that a burst of subresources costs one round trip to a worker thread
+// instead of one per request. Batches run in parallel on the thread pool,
+// each worker matching with clients of its own, see DATFileClient.
+class AdBlockTPMatchBatcher {
+ public:
+  static AdBlockTPMatchBatcher* GetInstance() {
+    static base::NoDestructor<AdBlockTPMatchBatcher> instance;
+    return instance.get();
+  }
+
+  AdBlockTPMatchBatcher()
+      : generation_(0),
+        flush_scheduled_(false),
+        latency_cap_(base::TimeDelta::FromMilliseconds(
+            kDefaultAdBlockTPBatchLatencyCapMs)),
+        match_callback_(
+            base::BindRepeating(&OnBeforeURLRequestAdBlockTPOnTaskRunner)) {}
+
+  void set_latency_cap(base::TimeDelta latency_cap) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+    latency_cap_ = latency_cap;
+  }
+
+  void set_timer_task_runner(
+      scoped_refptr<base::SingleThreadTaskRunner> task_runner) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+    timer_task_runner_ = std::move(task_runner);
+  }
+
+  void set_match_callback(const AdBlockTPMatchCallback& match_callback) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+    match_callback_ = match_callback;
+  }
+
+  void Add(const ResponseCallback& next_callback,
+           std::shared_ptr<BraveRequestInfo> ctx) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+    next_callbacks_.push_back(next_callback);
+    ctxs_.push_back(ctx);
+    if (ctxs_.size() >= kMaxAdBlockTPBatchSize) {
+      Flush(generation_);
+      return;
+    }
+    if (!flush_scheduled_) {
+      flush_scheduled_ = true;
+      base::OnceClosure flush_task =
+          base::BindOnce(&AdBlockTPMatchBatcher::Flush,
+                         base::Unretained(this), generation_);
+      if (timer_task_runner_) {
+        timer_task_runner_->PostDelayedTask(FROM_HERE, std::move(flush_task),
+                                            latency_cap_);
+      } else {
+        base::PostDelayedTaskWithTraits(FROM_HERE,
+            {content::BrowserThread::IO}, std::move(flush_task),
+            latency_cap_);
+      }
+    }
+  }
+
+ private:
+  static void DispatchOnIOThread(
+      const std::vector<ResponseCallback>& next_callbacks,
+      const std::vector<std::shared_ptr<BraveRequestInfo>>& ctxs) {
+    for (size_t i = 0; i < ctxs.size(); ++i) {
+      OnBeforeURLRequestDispatchOnIOThread(next_callbacks[i], ctxs[i]);
+    }
+  }
+
+  void Flush(uint64_t generation) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+    // A size triggered flush already sent the batch this task was for.
+    if (generation != generation_ || ctxs_.empty()) {
+      return;
+    }
+    ++generation_;
+    flush_scheduled_ = false;
+
+    std::vector<ResponseCallback> next_callbacks;
+    std::vector<std::shared_ptr<BraveRequestInfo>> ctxs;
+    next_callbacks.swap(next_callbacks_);
+    ctxs.swap(ctxs_);
+    base::OnceClosure match_task = base::BindOnce(
+        &OnBeforeURLRequestAdBlockTPBatchOnTaskRunner, match_callback_, ctxs);
+    // Matching may deserialize a client over a list and may release the
+    // last reference to a replaced list.
+    base::PostTaskWithTraitsAndReply(FROM_HERE,
+        {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        std::move(match_task),
+        base::BindOnce(&AdBlockTPMatchBatcher::DispatchOnIOThread,
+                       std::move(next_callbacks), std::move(ctxs)));
+  }
+
+  uint64_t generation_;
+  bool flush_scheduled_;
+  std::vector<ResponseCallback> next_callbacks_;
+  std::vector<std::shared_ptr<BraveRequestInfo>> ctxs_;
+  base::TimeDelta latency_cap_;
+  // Null unless replaced for testing, the IO thread is used then.
+  scoped_refptr<base::SingleThreadTaskRunner> timer_task_runner_;
+  AdBlockTPMatchCallback match_callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockTPMatchBatcher);
+};
+
+void SetAdBlockTPBatchLatencyCapForTesting(base::TimeDelta latency_cap) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  AdBlockTPMatchBatcher::GetInstance()->set_latency_cap(latency_cap);
+}
+
+void SetAdBlockTPBatchTimerTaskRunnerForTesting(
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  AdBlockTPMatchBatcher::GetInstance()->set_timer_task_runner(
+      std::move(task_runner));
+}
+
+void SetAdBlockTPMatchCallbackForTesting(
+    const AdBlockTPMatchCallback& match_callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  AdBlockTPMatchBatcher::GetInstance()->set_match_callback(
+      match_callback.is_null() ?
+          base::BindRepeating(&OnBeforeURLRequestAdBlockTPOnTaskRunner) :
+          match_callback);
+}
+
 int OnBeforeURLRequest_AdBlockTPPreWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx) {
@@ -159,11 +304,7 @@ int OnBeforeURLRequest_AdBlockTPPreWork(
     return net::OK;
   }
 
-  g_brave_browser_process->ad_block_service()->
-        GetTaskRunner()->PostTaskAndReply(FROM_HERE,
-          base::Bind(&OnBeforeURLRequestAdBlockTPOnTaskRunner, ctx),
-          base::Bind(base::IgnoreResult(
-              &OnBeforeURLRequestDispatchOnIOThread), next_callback, ctx));
+  AdBlockTPMatchBatcher::GetInstance()->Add(next_callback, ctx);
 
   return net::ERR_IO_PENDING;
 }
@@ -5,14 +5,37 @@
 #ifndef BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_TP_NETWORK_DELEGATE_H_
 #define BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_TP_NETWORK_DELEGATE_H_
 
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/single_thread_task_runner.h"
+#include "base/time/time.h"
 #include "brave/browser/net/url_context.h"
 
 namespace brave {
 
+using AdBlockTPMatchCallback =
+    base::RepeatingCallback<void(std::shared_ptr<BraveRequestInfo>)>;
+
 int OnBeforeURLRequest_AdBlockTPPreWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx);
 
+// Sets how long a pending ad-block / tracking protection match request may
+// wait for others to be batched with it before being evaluated, and the task
+// runner that wait is timed on, a null one restores the IO thread. Must be
+// called on the IO thread.
+void SetAdBlockTPBatchLatencyCapForTesting(base::TimeDelta latency_cap);
+void SetAdBlockTPBatchTimerTaskRunnerForTesting(
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner);
+
+// Replaces the ad-block / tracking protection match run for each batched
+// request, a null callback restores it. Must be called on the IO thread.
+void SetAdBlockTPMatchCallbackForTesting(
+    const AdBlockTPMatchCallback& match_callback);
+
 bool GetPolyfillForAdBlock(bool allow_brave_shields, bool allow_ads,
     const GURL& tab_origin, const GURL& gurl, std::string* new_url_spec);
 
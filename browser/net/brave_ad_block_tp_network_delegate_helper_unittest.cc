@@ -4,6 +4,14 @@
 
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/strings/string_util.h"
+#include "base/test/test_mock_time_task_runner.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
 #include "chrome/test/base/chrome_render_view_host_test_harness.h"
@@ -14,6 +22,57 @@ using brave::GetPolyfillForAdBlock;
 
 namespace {
 
+const char kBatchedBlockedURL[] = "https://a.com/block.js";
+const char kBatchedAllowedURL[] = "https://a.com/allow.js";
+
+void MatchBlockPath(std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  if (base::EndsWith(ctx->request_url.path(), "/block.js",
+                     base::CompareCase::SENSITIVE)) {
+    ctx->new_url_spec = kEmptyDataURI;
+  }
+}
+
+std::shared_ptr<brave::BraveRequestInfo> CreateBatchedRequest(
+    const GURL& url, uint64_t request_identifier) {
+  std::shared_ptr<brave::BraveRequestInfo>
+      brave_request_info(new brave::BraveRequestInfo());
+  brave_request_info->request_url = url;
+  brave_request_info->tab_origin = GURL("https://brave.com");
+  brave_request_info->resource_type = content::RESOURCE_TYPE_SCRIPT;
+  brave_request_info->request_identifier = request_identifier;
+  return brave_request_info;
+}
+
+// Collects the replies of batched requests in the order they arrive.
+class BatchedReplies {
+ public:
+  BatchedReplies(size_t expected, const base::Closure& quit_closure)
+      : expected_(expected), quit_closure_(quit_closure) {}
+
+  brave::ResponseCallback Add(
+      std::shared_ptr<brave::BraveRequestInfo> ctx) {
+    return base::Bind(&BatchedReplies::OnReply, base::Unretained(this), ctx);
+  }
+
+  const std::vector<uint64_t>& order() const { return order_; }
+  size_t mismatches() const { return mismatches_; }
+
+ private:
+  void OnReply(std::shared_ptr<brave::BraveRequestInfo> ctx) {
+    order_.push_back(ctx->request_identifier);
+    const bool blocked = ctx->new_url_spec == kEmptyDataURI;
+    if (blocked != (ctx->request_url == GURL(kBatchedBlockedURL)))
+      mismatches_++;
+    if (order_.size() == expected_)
+      quit_closure_.Run();
+  }
+
+  size_t expected_;
+  base::Closure quit_closure_;
+  std::vector<uint64_t> order_;
+  size_t mismatches_ = 0;
+};
+
 class BraveAdBlockTPNetworkDelegateHelperTest: public testing::Test {
  public:
   BraveAdBlockTPNetworkDelegateHelperTest()
@@ -23,12 +82,26 @@ class BraveAdBlockTPNetworkDelegateHelperTest: public testing::Test {
   ~BraveAdBlockTPNetworkDelegateHelperTest() override {}
   void SetUp() override {
     context_->Init();
+    // Batches wait on mock time, so tests decide when the latency cap
+    // expires.
+    timer_task_runner_ = new base::TestMockTimeTaskRunner();
+    brave::SetAdBlockTPBatchTimerTaskRunnerForTesting(timer_task_runner_);
+  }
+  void TearDown() override {
+    brave::SetAdBlockTPMatchCallbackForTesting(brave::AdBlockTPMatchCallback());
+    brave::SetAdBlockTPBatchLatencyCapForTesting(
+        base::TimeDelta::FromMilliseconds(2));
+    brave::SetAdBlockTPBatchTimerTaskRunnerForTesting(nullptr);
   }
   net::TestURLRequestContext* context() { return context_.get(); }
+  base::TestMockTimeTaskRunner* timer_task_runner() {
+    return timer_task_runner_.get();
+  }
 
  private:
   content::TestBrowserThreadBundle thread_bundle_;
   std::unique_ptr<net::TestURLRequestContext> context_;
+  scoped_refptr<base::TestMockTimeTaskRunner> timer_task_runner_;
 };
 
 
@@ -175,4 +248,90 @@ TEST_F(BraveAdBlockTPNetworkDelegateHelperTest, GetPolyfill) {
   ASSERT_FALSE(GetPolyfillForAdBlock(false, false, tab_origin, normal_url, &out_url_spec));
 }
 
+TEST_F(BraveAdBlockTPNetworkDelegateHelperTest, BatchFlushesWhenFull) {
+  // Mock time never advances, so only a full batch is sent.
+  brave::SetAdBlockTPMatchCallbackForTesting(
+      base::BindRepeating(&MatchBlockPath));
+
+  const size_t kBatchSize = 64;
+  base::RunLoop run_loop;
+  BatchedReplies replies(kBatchSize, run_loop.QuitClosure());
+  for (size_t i = 0; i < kBatchSize; ++i) {
+    auto ctx = CreateBatchedRequest(
+        GURL(i % 2 ? kBatchedBlockedURL : kBatchedAllowedURL), i + 1);
+    EXPECT_EQ(OnBeforeURLRequest_AdBlockTPPreWork(replies.Add(ctx), ctx),
+              net::ERR_IO_PENDING);
+  }
+  run_loop.Run();
+
+  ASSERT_EQ(replies.order().size(), kBatchSize);
+  for (size_t i = 0; i < kBatchSize; ++i)
+    EXPECT_EQ(replies.order()[i], i + 1);
+  EXPECT_EQ(replies.mismatches(), 0u);
+}
+
+TEST_F(BraveAdBlockTPNetworkDelegateHelperTest, BatchFlushesOnTimer) {
+  brave::SetAdBlockTPBatchLatencyCapForTesting(
+      base::TimeDelta::FromMilliseconds(100));
+  brave::SetAdBlockTPMatchCallbackForTesting(
+      base::BindRepeating(&MatchBlockPath));
+
+  base::RunLoop run_loop;
+  BatchedReplies replies(3, run_loop.QuitClosure());
+  const std::vector<GURL> urls({
+    GURL(kBatchedBlockedURL),
+    GURL(kBatchedAllowedURL),
+    GURL(kBatchedBlockedURL)
+  });
+  for (size_t i = 0; i < urls.size(); ++i) {
+    auto ctx = CreateBatchedRequest(urls[i], i + 1);
+    EXPECT_EQ(OnBeforeURLRequest_AdBlockTPPreWork(replies.Add(ctx), ctx),
+              net::ERR_IO_PENDING);
+  }
+  // Nothing is matched before the latency cap expires
+  timer_task_runner()->FastForwardBy(base::TimeDelta::FromMilliseconds(99));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(replies.order().empty());
+
+  timer_task_runner()->FastForwardBy(base::TimeDelta::FromMilliseconds(1));
+  run_loop.Run();
+  EXPECT_EQ(replies.order(), std::vector<uint64_t>({1, 2, 3}));
+  EXPECT_EQ(replies.mismatches(), 0u);
+}
+
+TEST_F(BraveAdBlockTPNetworkDelegateHelperTest, BatchRepliesPerRequest) {
+  // One full batch followed by a timer flushed one
+  brave::SetAdBlockTPBatchLatencyCapForTesting(
+      base::TimeDelta::FromMilliseconds(10));
+  brave::SetAdBlockTPMatchCallbackForTesting(
+      base::BindRepeating(&MatchBlockPath));
+
+  const size_t kRequests = 64 + 5;
+  base::RunLoop run_loop;
+  BatchedReplies replies(kRequests, run_loop.QuitClosure());
+  for (size_t i = 0; i < kRequests; ++i) {
+    auto ctx = CreateBatchedRequest(
+        GURL(i % 3 ? kBatchedAllowedURL : kBatchedBlockedURL), i + 1);
+    EXPECT_EQ(OnBeforeURLRequest_AdBlockTPPreWork(replies.Add(ctx), ctx),
+              net::ERR_IO_PENDING);
+  }
+  timer_task_runner()->FastForwardBy(base::TimeDelta::FromMilliseconds(10));
+  run_loop.Run();
+
+  // Batches may finish in any order, requests of a batch reply in order
+  // and each reply carries its own request's result.
+  ASSERT_EQ(replies.order().size(), kRequests);
+  std::vector<uint64_t> full_batch;
+  std::vector<uint64_t> timer_batch;
+  for (uint64_t id : replies.order())
+    (id <= 64 ? full_batch : timer_batch).push_back(id);
+  ASSERT_EQ(full_batch.size(), 64u);
+  ASSERT_EQ(timer_batch.size(), 5u);
+  for (size_t i = 0; i < full_batch.size(); ++i)
+    EXPECT_EQ(full_batch[i], i + 1);
+  for (size_t i = 0; i < timer_batch.size(); ++i)
+    EXPECT_EQ(timer_batch[i], 64 + i + 1);
+  EXPECT_EQ(replies.mismatches(), 0u);
+}
+
 }  // namespace
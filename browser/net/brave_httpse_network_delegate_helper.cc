@@ -22,7 +22,8 @@ void OnBeforeURLRequest_HttpseFileWork(
       base::BlockingType::WILL_BLOCK);
   DCHECK(ctx->request_identifier != 0);
   g_brave_browser_process->https_everywhere_service()->
-    GetHTTPSURL(&ctx->request_url, ctx->request_identifier, ctx->new_url_spec);
+    GetHTTPSURL(&ctx->request_url, ctx->httpse_redirects_count,
+        ctx->new_url_spec);
 }
 
 void OnBeforeURLRequest_HttpsePostFileWork(
@@ -32,6 +33,7 @@ void OnBeforeURLRequest_HttpsePostFileWork(
 
   if (!ctx->new_url_spec.empty() &&
     ctx->new_url_spec != ctx->request_url.spec()) {
+    ctx->httpse_redirects_count++;
     brave_shields::DispatchBlockedEventFromIO(ctx->request_url,
         ctx->render_frame_id, ctx->render_process_id, ctx->frame_tree_node_id,
         brave_shields::kHTTPUpgradableResources);
@@ -67,8 +69,8 @@ int OnBeforeURLRequest_HttpsePreFileWork(
 
   if (is_valid_url) {
     if (!g_brave_browser_process->https_everywhere_service()->
-        GetHTTPSURLFromCacheOnly(&ctx->request_url, ctx->request_identifier,
-          ctx->new_url_spec)) {
+        GetHTTPSURLFromCacheOnly(&ctx->request_url,
+          ctx->httpse_redirects_count, ctx->new_url_spec)) {
       g_brave_browser_process->https_everywhere_service()->
         GetTaskRunner()->PostTaskAndReply(FROM_HERE,
           base::Bind(OnBeforeURLRequest_HttpseFileWork, ctx),
@@ -78,6 +80,7 @@ int OnBeforeURLRequest_HttpsePreFileWork(
       return net::ERR_IO_PENDING;
     } else {
       if (!ctx->new_url_spec.empty()) {
+        ctx->httpse_redirects_count++;
         brave_shields::DispatchBlockedEventFromIO(ctx->request_url,
             ctx->render_frame_id, ctx->render_process_id,
             ctx->frame_tree_node_id,
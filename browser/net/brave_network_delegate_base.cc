@@ -289,6 +289,7 @@ void BraveNetworkDelegateBase::RunNextCallback(
         IsRequestIdentifierValid(ctx->request_identifier)) {
       *ctx->new_url = GURL(ctx->new_url_spec);
     }
+    brave::BraveRequestInfo::UpdateRequestFromCTX(request, ctx);
     rv = ChromeNetworkDelegate::OnBeforeURLRequest(request,
         std::move(wrapped_callback), ctx->new_url);
   } else if (ctx->event_type == brave::kOnBeforeStartTransaction) {
@@ -7,12 +7,24 @@
 
 #include <string>
 
+#include "base/memory/ptr_util.h"
+#include "base/supports_user_data.h"
 #include "brave/common/url_constants.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "content/public/browser/resource_request_info.h"
 
+namespace {
+
+const char kHttpseRedirectsCountKey[] = "brave_httpse_redirects_count";
+
+struct HttpseRedirectsCount : public base::SupportsUserData::Data {
+  int count = 0;
+};
+
+}  // namespace
+
 namespace brave {
 
 BraveRequestInfo::BraveRequestInfo() {
@@ -25,6 +37,11 @@ void BraveRequestInfo::FillCTXFromRequest(const net::URLRequest* request,
     std::shared_ptr<brave::BraveRequestInfo> ctx) {
   ctx->request_identifier = request->identifier();
   ctx->request_url = request->url();
+  auto* httpse_redirects_count = static_cast<HttpseRedirectsCount*>(
+      request->GetUserData(kHttpseRedirectsCountKey));
+  if (httpse_redirects_count) {
+    ctx->httpse_redirects_count = httpse_redirects_count->count;
+  }
   auto* request_info = content::ResourceRequestInfo::ForRequest(request);
   if (request_info) {
     ctx->resource_type = request_info->GetResourceType();
@@ -63,4 +80,19 @@ void BraveRequestInfo::FillCTXFromRequest(const net::URLRequest* request,
   ctx->request = request;
 }
 
+void BraveRequestInfo::UpdateRequestFromCTX(net::URLRequest* request,
+    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  if (ctx->httpse_redirects_count == 0) {
+    return;
+  }
+  auto* httpse_redirects_count = static_cast<HttpseRedirectsCount*>(
+      request->GetUserData(kHttpseRedirectsCountKey));
+  if (!httpse_redirects_count) {
+    httpse_redirects_count = new HttpseRedirectsCount();
+    request->SetUserData(kHttpseRedirectsCountKey,
+                         base::WrapUnique(httpse_redirects_count));
+  }
+  httpse_redirects_count->count = ctx->httpse_redirects_count;
+}
+
 }  // namespace brave
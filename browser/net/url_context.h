@@ -63,6 +63,9 @@ struct BraveRequestInfo {
   int render_frame_id = 0;
   int frame_tree_node_id = 0;
   uint64_t request_identifier = 0;
+  // Number of HTTPS Everywhere upgrades applied to this request so far,
+  // carried across redirects on the URLRequest itself.
+  int httpse_redirects_count = 0;
   size_t next_url_request_index = 0;
   net::HttpRequestHeaders* headers = nullptr;
   const net::HttpResponseHeaders* original_response_headers = nullptr;
@@ -77,6 +80,10 @@ struct BraveRequestInfo {
 
   static void FillCTXFromRequest(const net::URLRequest* request,
     std::shared_ptr<brave::BraveRequestInfo> ctx);
+  // Stores the per-request state that has to survive redirects back on
+  // |request|.
+  static void UpdateRequestFromCTX(net::URLRequest* request,
+    std::shared_ptr<brave::BraveRequestInfo> ctx);
 
  private:
   // Please don't add any more friends here if it can be avoided.
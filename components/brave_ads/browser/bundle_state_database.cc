@@ -15,6 +15,12 @@
 #include "sql/statement.h"
 #include "sql/transaction.h"
 
+// Columns of the ad_info and staged_ad_info tables
+#define AD_INFO_COLUMNS \
+    "creative_set_id, advertiser, notification_text, notification_url, " \
+    "start_timestamp, end_timestamp, uuid, region, campaign_id, " \
+    "daily_cap, per_day, total_max"
+
 namespace brave_ads {
 
 namespace {
@@ -87,21 +93,6 @@ bool BundleStateDatabase::CreateCategoryTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateCategoryTable() {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-
-  bool initialized = Init();
-  DCHECK(initialized);
-
-  if (!initialized)
-    return false;
-
-  sql::Statement sql(
-      GetDB().GetCachedStatement(SQL_FROM_HERE, "DELETE FROM category"));
-  return sql.Run();
-}
-
-
 bool BundleStateDatabase::CreateAdInfoTable() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -109,7 +100,8 @@ bool BundleStateDatabase::CreateAdInfoTable() {
   if (GetDB().DoesTableExist(name))
     return true;
 
-  // Update InsertOrUpdateAdInfo() if you add anything here
+  // Update StageAdInfo(), CreateStagingTables() and AD_INFO_COLUMNS if you
+  // add anything here
   std::string sql;
   sql.append("CREATE TABLE ");
   sql.append(name);
@@ -131,20 +123,6 @@ bool BundleStateDatabase::CreateAdInfoTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateAdInfoTable() {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-
-  bool initialized = Init();
-  DCHECK(initialized);
-
-  if (!initialized)
-    return false;
-
-  sql::Statement sql(
-      GetDB().GetCachedStatement(SQL_FROM_HERE, "DELETE FROM ad_info"));
-  return sql.Run();
-}
-
 bool BundleStateDatabase::CreateAdInfoCategoryTable() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -171,20 +149,6 @@ bool BundleStateDatabase::CreateAdInfoCategoryTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateAdInfoCategoryTable() {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-
-  bool initialized = Init();
-  DCHECK(initialized);
-
-  if (!initialized)
-    return false;
-
-  sql::Statement sql(GetDB().GetCachedStatement(SQL_FROM_HERE,
-      "DELETE FROM ad_info_category"));
-  return sql.Run();
-}
-
 bool BundleStateDatabase::CreateAdInfoCategoryNameIndex() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -206,55 +170,118 @@ bool BundleStateDatabase::SaveBundleState(
   if (!GetDB().BeginTransaction())
     return false;
 
-  // we are completely replacing here so first truncate all the tables
-  if (!TruncateAdInfoCategoryTable() ||
-      !TruncateAdInfoTable() ||
-      !TruncateCategoryTable()) {
+  // The new catalog is staged in temporary tables and only the rows that
+  // differ from the saved catalog are written, so saving a catalog which
+  // mostly overlaps the previous one barely touches the database
+  if (!CreateStagingTables() ||
+      !ClearStagingTables() ||
+      !StageBundleState(bundle_state) ||
+      !ApplyStagedBundleState() ||
+      !ClearStagingTables()) {
     GetDB().RollbackTransaction();
     return false;
   }
 
-  auto categories = bundle_state.categories;
-  for (std::map<std::string, std::vector<ads::AdInfo>>::iterator it =
-      categories.begin();  it != categories.end(); ++it) {
-    auto category = it->first;
-    if (!InsertOrUpdateCategory(category)) {
-      GetDB().RollbackTransaction();
+  if (!GetDB().CommitTransaction())
+    return false;
+
+  if (ShouldVacuum())
+    Vacuum();
+
+  return true;
+}
+
+bool BundleStateDatabase::CreateStagingTables() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // Same columns as the tables created by CreateCategoryTable(),
+  // CreateAdInfoTable() and CreateAdInfoCategoryTable()
+  return GetDB().Execute(
+      "CREATE TEMP TABLE IF NOT EXISTS staged_category "
+      "(name LONGVARCHAR PRIMARY KEY);"
+      "CREATE TEMP TABLE IF NOT EXISTS staged_ad_info "
+      "("
+      "creative_set_id LONGVARCHAR,"
+      "advertiser LONGVARCHAR,"
+      "notification_text TEXT,"
+      "notification_url LONGVARCHAR,"
+      "start_timestamp DATETIME,"
+      "end_timestamp DATETIME,"
+      "uuid LONGVARCHAR,"
+      "region VARCHAR,"
+      "campaign_id LONGVARCHAR,"
+      "daily_cap INTEGER DEFAULT 0 NOT NULL,"
+      "per_day INTEGER DEFAULT 0 NOT NULL,"
+      "total_max INTEGER DEFAULT 0 NOT NULL,"
+      "PRIMARY KEY(region, uuid));"
+      "CREATE TEMP TABLE IF NOT EXISTS staged_ad_info_category "
+      "("
+      "ad_info_uuid LONGVARCHAR NOT NULL,"
+      "category_name LONGVARCHAR NOT NULL,"
+      "UNIQUE(ad_info_uuid, category_name) ON CONFLICT REPLACE)");
+}
+
+bool BundleStateDatabase::ClearStagingTables() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  return GetDB().Execute(
+      "DELETE FROM staged_ad_info_category;"
+      "DELETE FROM staged_ad_info;"
+      "DELETE FROM staged_category");
+}
+
+bool BundleStateDatabase::StageBundleState(
+    const ads::BundleState& bundle_state) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  for (const auto& it : bundle_state.categories) {
+    const std::string& category = it.first;
+    if (!StageCategory(category))
       return false;
-    }
 
-    auto ads = it->second;
-    for (std::vector<ads::AdInfo>::iterator ad_it = ads.begin();
-        ad_it != ads.end(); ++ad_it) {
-      auto ad_info = *ad_it;
-      if (!InsertOrUpdateAdInfo(ad_info) ||
-          !InsertOrUpdateAdInfoCategory(ad_info, category)) {
-        GetDB().RollbackTransaction();
+    for (const auto& ad_info : it.second) {
+      if (!StageAdInfo(ad_info) ||
+          !StageAdInfoCategory(ad_info, category)) {
         return false;
       }
     }
   }
 
-  if (GetDB().CommitTransaction()) {
-    Vacuum();
-    return true;
-  }
-
-  return false;
+  return true;
 }
 
-bool BundleStateDatabase::InsertOrUpdateCategory(const std::string& category) {
+bool BundleStateDatabase::ApplyStagedBundleState() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  bool initialized = Init();
-  DCHECK(initialized);
+  // Removes the rows which are no longer in the catalog, then inserts the
+  // new and changed ones. Unchanged rows are left alone
+  return GetDB().Execute(
+      "DELETE FROM ad_info_category WHERE NOT EXISTS "
+      "(SELECT 1 FROM staged_ad_info_category AS s "
+      "WHERE s.ad_info_uuid = ad_info_category.ad_info_uuid "
+      "AND s.category_name = ad_info_category.category_name);"
+      "DELETE FROM ad_info WHERE NOT EXISTS "
+      "(SELECT 1 FROM staged_ad_info AS s "
+      "WHERE s.region = ad_info.region AND s.uuid = ad_info.uuid);"
+      "DELETE FROM category WHERE name NOT IN "
+      "(SELECT name FROM staged_category);"
+      "INSERT INTO category (name) "
+      "SELECT name FROM staged_category "
+      "EXCEPT SELECT name FROM category;"
+      "INSERT OR REPLACE INTO ad_info (" AD_INFO_COLUMNS ") "
+      "SELECT " AD_INFO_COLUMNS " FROM staged_ad_info "
+      "EXCEPT SELECT " AD_INFO_COLUMNS " FROM ad_info;"
+      "INSERT INTO ad_info_category (ad_info_uuid, category_name) "
+      "SELECT ad_info_uuid, category_name FROM staged_ad_info_category "
+      "EXCEPT SELECT ad_info_uuid, category_name FROM ad_info_category");
+}
 
-  if (!initialized)
-    return false;
+bool BundleStateDatabase::StageCategory(const std::string& category) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   sql::Statement ad_info_statement(
       GetDB().GetCachedStatement(SQL_FROM_HERE,
-          "INSERT OR REPLACE INTO category "
+          "INSERT OR REPLACE INTO staged_category "
           "(name) "
           "VALUES (?)"));
 
@@ -263,20 +290,13 @@ bool BundleStateDatabase::InsertOrUpdateCategory(const std::string& category) {
   return ad_info_statement.Run();
 }
 
-bool BundleStateDatabase::InsertOrUpdateAdInfo(const ads::AdInfo& info) {
+bool BundleStateDatabase::StageAdInfo(const ads::AdInfo& info) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  bool initialized = Init();
-  DCHECK(initialized);
-
-  if (!initialized)
-    return false;
-
-  for (auto it = info.regions.begin(); it != info.regions.end(); ++it) {
-
+  for (const auto& region : info.regions) {
     sql::Statement ad_info_statement(
         GetDB().GetCachedStatement(SQL_FROM_HERE,
-            "INSERT OR REPLACE INTO ad_info "
+            "INSERT OR REPLACE INTO staged_ad_info "
             "(creative_set_id, advertiser, notification_text, "
             "notification_url, start_timestamp, end_timestamp, uuid, "
             "campaign_id, daily_cap, per_day, total_max, region) "
@@ -293,7 +313,7 @@ bool BundleStateDatabase::InsertOrUpdateAdInfo(const ads::AdInfo& info) {
     ad_info_statement.BindInt(8, info.daily_cap);
     ad_info_statement.BindInt(9, info.per_day);
     ad_info_statement.BindInt(10, info.total_max);
-    ad_info_statement.BindString(11, *it);
+    ad_info_statement.BindString(11, region);
     if (!ad_info_statement.Run()) {
       return false;
     }
@@ -302,20 +322,14 @@ bool BundleStateDatabase::InsertOrUpdateAdInfo(const ads::AdInfo& info) {
   return true;
 }
 
-bool BundleStateDatabase::InsertOrUpdateAdInfoCategory(
+bool BundleStateDatabase::StageAdInfoCategory(
     const ads::AdInfo& ad_info,
     const std::string& category) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  bool initialized = Init();
-  DCHECK(initialized);
-
-  if (!initialized)
-    return false;
-
   sql::Statement ad_info_statement(
       GetDB().GetCachedStatement(SQL_FROM_HERE,
-          "INSERT OR REPLACE INTO ad_info_category "
+          "INSERT OR REPLACE INTO staged_ad_info_category "
           "(ad_info_uuid, category_name) "
           "VALUES (?, ?)"));
 
@@ -379,6 +393,19 @@ int BundleStateDatabase::GetCurrentVersion() {
   return kCurrentVersionNumber;
 }
 
+bool BundleStateDatabase::ShouldVacuum() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Statement page_count(GetDB().GetUniqueStatement("PRAGMA page_count"));
+  sql::Statement freelist_count(
+      GetDB().GetUniqueStatement("PRAGMA freelist_count"));
+  if (!page_count.Step() || !freelist_count.Step())
+    return false;
+
+  // Only worth it once a quarter of the file is unused pages
+  return freelist_count.ColumnInt64(0) * 4 > page_count.ColumnInt64(0);
+}
+
 void BundleStateDatabase::Vacuum() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
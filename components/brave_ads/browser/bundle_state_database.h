@@ -57,14 +57,18 @@ class BundleStateDatabase {
   bool CreateAdInfoCategoryTable();
   bool CreateAdInfoCategoryNameIndex();
 
-  bool TruncateCategoryTable();
-  bool TruncateAdInfoTable();
-  bool TruncateAdInfoCategoryTable();
-
-  bool InsertOrUpdateCategory(const std::string& category);
-  bool InsertOrUpdateAdInfo(const ads::AdInfo& info);
-  bool InsertOrUpdateAdInfoCategory(const ads::AdInfo& ad_info,
-                                    const std::string& category);
+  bool CreateStagingTables();
+  bool ClearStagingTables();
+  bool StageBundleState(const ads::BundleState& bundle_state);
+  bool ApplyStagedBundleState();
+
+  bool StageCategory(const std::string& category);
+  bool StageAdInfo(const ads::AdInfo& info);
+  bool StageAdInfoCategory(const ads::AdInfo& ad_info,
+                           const std::string& category);
+
+  // Returns true if enough of the database file is unused to vacuum it.
+  bool ShouldVacuum();
 
   sql::Database& GetDB();
   sql::MetaTable& GetMetaTable();
@@ -0,0 +1,133 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/browser/bundle_state_database.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/scoped_task_environment.h"
+#include "sql/statement.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BundleStateDatabaseTest.*
+
+namespace brave_ads {
+
+namespace {
+
+ads::AdInfo CreateAdInfo(const std::string& uuid,
+                         const std::string& notification_text) {
+  ads::AdInfo info;
+  info.creative_set_id = "creative-set-" + uuid;
+  info.advertiser = "Brave";
+  info.notification_text = notification_text;
+  info.notification_url = "https://brave.com/" + uuid;
+  info.start_timestamp = "2000-01-01 00:00";
+  info.end_timestamp = "2100-01-01 00:00";
+  info.uuid = uuid;
+  info.campaign_id = "campaign-" + uuid;
+  info.daily_cap = 1;
+  info.per_day = 2;
+  info.total_max = 3;
+  info.regions.push_back("US");
+  return info;
+}
+
+std::vector<std::string> GetUuids(const std::vector<ads::AdInfo>& ads) {
+  std::vector<std::string> uuids;
+  for (const auto& info : ads)
+    uuids.push_back(info.uuid);
+  std::sort(uuids.begin(), uuids.end());
+  return uuids;
+}
+
+}  // namespace
+
+class BundleStateDatabaseTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    database_.reset(new BundleStateDatabase(
+        temp_dir_.GetPath().AppendASCII("bundle_state")));
+  }
+
+  std::vector<ads::AdInfo> GetAdsForCategory(const std::string& category) {
+    std::vector<ads::AdInfo> ads;
+    EXPECT_TRUE(database_->GetAdsForCategory("US", category, ads));
+    return ads;
+  }
+
+  // Reads a single count from the database file, bypassing the API.
+  int Count(const std::string& sql) {
+    sql::Database db;
+    EXPECT_TRUE(db.Open(temp_dir_.GetPath().AppendASCII("bundle_state")));
+    sql::Statement statement(db.GetUniqueStatement(sql.c_str()));
+    EXPECT_TRUE(statement.Step());
+    return statement.ColumnInt(0);
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<BundleStateDatabase> database_;
+};
+
+TEST_F(BundleStateDatabaseTest, SavesOverlappingCatalog) {
+  ads::BundleState catalog_a;
+  catalog_a.categories["Technology"] = {
+      CreateAdInfo("ad1", "one"), CreateAdInfo("ad2", "two")};
+  catalog_a.categories["Sports"] = {CreateAdInfo("ad3", "three")};
+  ASSERT_TRUE(database_->SaveBundleState(catalog_a));
+
+  EXPECT_EQ(GetUuids(GetAdsForCategory("Technology")),
+            std::vector<std::string>({"ad1", "ad2"}));
+  EXPECT_EQ(GetUuids(GetAdsForCategory("Sports")),
+            std::vector<std::string>({"ad3"}));
+
+  // Keeps ad2 with a new text, drops ad1, ad3 and Sports, adds ad4 and
+  // Travel.
+  ads::BundleState catalog_b;
+  catalog_b.categories["Technology"] = {
+      CreateAdInfo("ad2", "two changed"), CreateAdInfo("ad4", "four")};
+  catalog_b.categories["Travel"] = {CreateAdInfo("ad5", "five")};
+  ASSERT_TRUE(database_->SaveBundleState(catalog_b));
+
+  const std::vector<ads::AdInfo> technology = GetAdsForCategory("Technology");
+  EXPECT_EQ(GetUuids(technology), std::vector<std::string>({"ad2", "ad4"}));
+  for (const auto& info : technology) {
+    if (info.uuid == "ad2") {
+      EXPECT_EQ(info.notification_text, "two changed");
+      EXPECT_EQ(info.notification_url, "https://brave.com/ad2");
+      EXPECT_EQ(info.daily_cap, CreateAdInfo("ad2", "").daily_cap);
+    }
+  }
+  EXPECT_TRUE(GetAdsForCategory("Sports").empty());
+  EXPECT_EQ(GetUuids(GetAdsForCategory("Travel")),
+            std::vector<std::string>({"ad5"}));
+
+  // Nothing of catalog A is left behind.
+  database_.reset();
+  EXPECT_EQ(Count("SELECT COUNT(*) FROM category"), 2);
+  EXPECT_EQ(Count("SELECT COUNT(*) FROM category WHERE name = 'Sports'"), 0);
+  EXPECT_EQ(Count("SELECT COUNT(*) FROM ad_info"), 3);
+  EXPECT_EQ(Count("SELECT COUNT(*) FROM ad_info "
+                  "WHERE uuid IN ('ad1', 'ad3')"), 0);
+  EXPECT_EQ(Count("SELECT COUNT(*) FROM ad_info_category"), 3);
+}
+
+TEST_F(BundleStateDatabaseTest, SavesSameCatalogTwice) {
+  ads::BundleState catalog;
+  catalog.categories["Technology"] = {CreateAdInfo("ad1", "one")};
+  ASSERT_TRUE(database_->SaveBundleState(catalog));
+  ASSERT_TRUE(database_->SaveBundleState(catalog));
+
+  const std::vector<ads::AdInfo> ads = GetAdsForCategory("Technology");
+  ASSERT_EQ(ads.size(), 1u);
+  EXPECT_EQ(ads[0].notification_text, "one");
+}
+
+}  // namespace brave_ads
@@ -169,9 +169,17 @@ bool PublisherInfoDatabase::CreateActivityInfoTable() {
 bool PublisherInfoDatabase::CreateActivityInfoIndex() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+  // The last two match the filters used for the auto contribute list, which
+  // is paged by publisher id or ordered by percent within a reconcile stamp.
   return GetDB().Execute(
       "CREATE INDEX IF NOT EXISTS activity_info_publisher_id_index "
-      "ON activity_info (publisher_id)");
+      "ON activity_info (publisher_id)") &&
+      GetDB().Execute(
+      "CREATE INDEX IF NOT EXISTS activity_info_stamp_publisher_id_index "
+      "ON activity_info (category, reconcile_stamp, publisher_id)") &&
+      GetDB().Execute(
+      "CREATE INDEX IF NOT EXISTS activity_info_stamp_percent_index "
+      "ON activity_info (category, reconcile_stamp, percent)");
 }
 
 bool PublisherInfoDatabase::CreateMediaPublisherInfoTable() {
@@ -238,6 +246,33 @@ bool PublisherInfoDatabase::InsertOrUpdatePublisherInfo(
   if (!initialized)
     return false;
 
+  return InsertOrUpdatePublisherInfoInternal(info);
+}
+
+bool PublisherInfoDatabase::InsertOrUpdatePublisherInfoList(
+    const ledger::PublisherInfoList& list) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  bool initialized = Init();
+  DCHECK(initialized);
+
+  if (!initialized)
+    return false;
+
+  sql::Transaction transaction(&GetDB());
+  if (!transaction.Begin())
+    return false;
+
+  for (const auto& info : list) {
+    if (!InsertOrUpdatePublisherInfoInternal(info))
+      return false;
+  }
+
+  return transaction.Commit();
+}
+
+bool PublisherInfoDatabase::InsertOrUpdatePublisherInfoInternal(
+    const ledger::PublisherInfo& info) {
   sql::Statement publisher_info_statement(
       GetDB().GetCachedStatement(SQL_FROM_HERE,
           "INSERT OR REPLACE INTO publisher_info "
@@ -262,9 +297,10 @@ bool PublisherInfoDatabase::InsertOrUpdatePublisherInfo(
   }
 
   sql::Statement activity_get(
-      db_.GetUniqueStatement("SELECT publisher_id FROM activity_info WHERE "
-                             "publisher_id=? AND category=? "
-                             "AND month=? AND year=? AND reconcile_stamp=?"));
+      GetDB().GetCachedStatement(SQL_FROM_HERE,
+          "SELECT publisher_id FROM activity_info WHERE "
+          "publisher_id=? AND category=? "
+          "AND month=? AND year=? AND reconcile_stamp=?"));
 
   activity_get.BindString(0, info.id);
   activity_get.BindInt(1, info.category);
@@ -281,9 +317,9 @@ bool PublisherInfoDatabase::InsertOrUpdatePublisherInfo(
           "publisher_id=? AND category=? "
           "AND month=? AND year=? AND reconcile_stamp=?"));
 
-    activity_info_update.BindInt64(0, (int)info.duration);
+    activity_info_update.BindInt64(0, static_cast<int64_t>(info.duration));
     activity_info_update.BindDouble(1, info.score);
-    activity_info_update.BindInt64(2, (int)info.percent);
+    activity_info_update.BindInt64(2, static_cast<int64_t>(info.percent));
     activity_info_update.BindDouble(3, info.weight);
     activity_info_update.BindString(4, info.id);
     activity_info_update.BindInt(5, info.category);
@@ -302,9 +338,9 @@ bool PublisherInfoDatabase::InsertOrUpdatePublisherInfo(
         "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)"));
 
   activity_info_insert.BindString(0, info.id);
-  activity_info_insert.BindInt64(1, (int)info.duration);
+  activity_info_insert.BindInt64(1, static_cast<int64_t>(info.duration));
   activity_info_insert.BindDouble(2, info.score);
-  activity_info_insert.BindInt64(3, (int)info.percent);
+  activity_info_insert.BindInt64(3, static_cast<int64_t>(info.percent));
   activity_info_insert.BindDouble(4, info.weight);
   activity_info_insert.BindInt(5, info.category);
   activity_info_insert.BindInt(6, info.month);
@@ -390,11 +426,21 @@ bool PublisherInfoDatabase::Find(int start,
       "INNER JOIN publisher_info AS pi ON ai.publisher_id = pi.publisher_id "
       "WHERE 1 = 1";
 
-  query+= BuildClauses(start, limit, filter);
+  query+= BuildClauses(filter);
+
+  for (size_t i = 0; i < filter.order_by.size(); i++) {
+    query += i == 0 ? " ORDER BY " : ", ";
+    query += filter.order_by[i].first;
+    query += filter.order_by[i].second ? " ASC" : " DESC";
+  }
 
-  sql::Statement info_sql(db_.GetUniqueStatement(query.c_str()));
+  query += " LIMIT ? OFFSET ?";
 
-  BindFilter(info_sql, filter);
+  sql::Statement info_sql(GetCachedFilterStatement(query));
+
+  int column = BindFilter(info_sql, filter);
+  info_sql.BindInt(column++, limit > 0 ? limit : -1);
+  info_sql.BindInt(column++, start > 1 ? start : 0);
 
   while (info_sql.Step()) {
     std::string id(info_sql.ColumnString(0));
@@ -439,9 +485,9 @@ int PublisherInfoDatabase::Count(const ledger::PublisherInfoFilter& filter) {
       "INNER JOIN publisher_info AS pi ON ai.publisher_id = pi.publisher_id "
       "WHERE 1 = 1";
 
-  query+= BuildClauses(0, 0, filter);
+  query+= BuildClauses(filter);
 
-  sql::Statement publisher_count(db_.GetUniqueStatement(query.c_str()));
+  sql::Statement publisher_count(GetCachedFilterStatement(query));
 
   BindFilter(publisher_count, filter);
 
@@ -451,14 +497,26 @@ int PublisherInfoDatabase::Count(const ledger::PublisherInfoFilter& filter) {
   return publisher_count.ColumnInt(0);
 }
 
-std::string PublisherInfoDatabase::BuildClauses(int start,
-                                                int limit,
-                                                const ledger::PublisherInfoFilter& filter) {
+scoped_refptr<sql::Database::StatementRef>
+PublisherInfoDatabase::GetCachedFilterStatement(const std::string& query) {
+  // Filter values are always bound, so |query| only depends on the shape of
+  // the filter. The statement id keeps a pointer to its name, which has to
+  // stay valid for as long as the statement is cached.
+  const std::string& name = *filter_queries_.insert(query).first;
+  return GetDB().GetCachedStatement(sql::StatementID(name.c_str()),
+                                    name.c_str());
+}
+
+std::string PublisherInfoDatabase::BuildClauses(
+    const ledger::PublisherInfoFilter& filter) {
   std::string clauses = "";
 
   if (!filter.id.empty())
     clauses += " AND ai.publisher_id = ?";
 
+  if (!filter.after_id.empty())
+    clauses += " AND ai.publisher_id > ?";
+
   if (filter.category != ledger::PUBLISHER_CATEGORY::ALL_CATEGORIES)
     clauses += " AND ai.category = ?";
 
@@ -491,28 +549,18 @@ std::string PublisherInfoDatabase::BuildClauses(int start,
     clauses += " AND pi.verified = 1";
   }
 
-  for (const auto& it : filter.order_by) {
-    clauses += " ORDER BY " + it.first;
-    clauses += (it.second ? " ASC" : " DESC");
-  }
-
-  if (limit > 0) {
-    clauses += " LIMIT " + std::to_string(limit);
-
-    if (start > 1) {
-      clauses += " OFFSET " + std::to_string(start);
-    }
-  }
-
   return clauses;
 }
 
-void PublisherInfoDatabase::BindFilter(sql::Statement& statement,
-                                       const ledger::PublisherInfoFilter& filter) {
+int PublisherInfoDatabase::BindFilter(sql::Statement& statement,
+                                      const ledger::PublisherInfoFilter& filter) {
   int column = 0;
   if (!filter.id.empty())
     statement.BindString(column++, filter.id);
 
+  if (!filter.after_id.empty())
+    statement.BindString(column++, filter.after_id);
+
   if (filter.category != ledger::PUBLISHER_CATEGORY::ALL_CATEGORIES)
     statement.BindInt(column++, filter.category);
 
@@ -539,6 +587,8 @@ void PublisherInfoDatabase::BindFilter(sql::Statement& statement,
 
   if (filter.percent > 0)
     statement.BindInt(column++, filter.percent);
+
+  return column;
 }
 
 bool PublisherInfoDatabase::InsertContributionInfo(const brave_rewards::ContributionInfo& info) {
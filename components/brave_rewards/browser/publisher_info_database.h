@@ -6,12 +6,15 @@
 #define BRAVE_COMPONENTS_BRAVE_REWARDS_PUBLISHER_INFO_DATABASE_H_
 
 #include <memory>
+#include <set>
 #include <stddef.h>
+#include <string>
 
 #include "base/compiler_specific.h"
 #include "base/files/file_path.h"
 #include "base/macros.h"
 #include "base/memory/memory_pressure_listener.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/sequence_checker.h"
 #include "bat/ledger/publisher_info.h"
 #include "brave/components/brave_rewards/browser/contribution_info.h"
@@ -35,6 +38,9 @@ class PublisherInfoDatabase {
   }
 
   bool InsertOrUpdatePublisherInfo(const ledger::PublisherInfo& info);
+  // Saves all of |list| in a single transaction, nothing is saved if any
+  // row fails.
+  bool InsertOrUpdatePublisherInfoList(const ledger::PublisherInfoList& list);
   bool InsertOrUpdateMediaPublisherInfo(const std::string& media_key, const std::string& publisher_id);
   bool InsertContributionInfo(const brave_rewards::ContributionInfo& info);
   bool InsertOrUpdateRecurringDonation(const brave_rewards::RecurringDonation& info);
@@ -73,11 +79,14 @@ class PublisherInfoDatabase {
   bool CreateRecurringDonationTable();
   bool CreateRecurringDonationIndex();
 
-  std::string BuildClauses(int start,
-                           int limit,
-                           const ledger::PublisherInfoFilter& filter);
-  void BindFilter(sql::Statement& statement,
-                  const ledger::PublisherInfoFilter& filter);
+  bool InsertOrUpdatePublisherInfoInternal(const ledger::PublisherInfo& info);
+
+  scoped_refptr<sql::Database::StatementRef> GetCachedFilterStatement(
+      const std::string& query);
+  std::string BuildClauses(const ledger::PublisherInfoFilter& filter);
+  // Returns the index of the next parameter to bind.
+  int BindFilter(sql::Statement& statement,
+                 const ledger::PublisherInfoFilter& filter);
 
   sql::Database& GetDB();
   sql::MetaTable& GetMetaTable();
@@ -89,6 +98,9 @@ class PublisherInfoDatabase {
   sql::MetaTable meta_table_;
   const base::FilePath db_path_;
   bool initialized_;
+  // Queries of the cached Find() and Count() statements, one per filter
+  // shape.
+  std::set<std::string> filter_queries_;
 
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
@@ -23,6 +23,7 @@
 #include "base/task/post_task.h"
 #include "base/task_runner_util.h"
 #include "base/threading/sequenced_task_runner_handle.h"
+#include "base/timer/timer.h"
 #include "bat/ledger/ledger.h"
 #include "bat/ledger/auto_contribute_props.h"
 #include "bat/ledger/media_publisher_info.h"
@@ -167,6 +168,16 @@ std::string LoadStateOnFileTaskRunner(
   return data;
 }
 
+// Ledger and publisher state are written through StateWriter.
+std::string LoadWrittenStateOnFileTaskRunner(const base::FilePath& path) {
+  std::string data;
+  if (!StateWriter::ReadState(path, &data) || data.empty()) {
+    LOG(ERROR) << "Failed to read file: " << path.MaybeAsASCII();
+    return std::string();
+  }
+  return data;
+}
+
 bool SaveMediaPublisherInfoOnFileTaskRunner(
     const std::string& media_key,
     const std::string& publisher_id,
@@ -198,6 +209,15 @@ bool SavePublisherInfoOnFileTaskRunner(
   return false;
 }
 
+bool SavePublisherInfoListOnFileTaskRunner(
+    const ledger::PublisherInfoList list,
+    PublisherInfoDatabase* backend) {
+  if (backend && backend->InsertOrUpdatePublisherInfoList(list))
+    return true;
+
+  return false;
+}
+
 ledger::PublisherInfoList LoadPublisherInfoListOnFileTaskRunner(
     uint32_t start,
     uint32_t limit,
@@ -265,6 +285,15 @@ const base::FilePath::StringType kPublisher_info_db("publisher_info_db");
 const base::FilePath::StringType kPublishers_list("publishers_list");
 #endif
 
+// Ledger and publisher state saves are coalesced and hit the disk at most
+// once per interval, see StateWriter.
+const int kStateSaveIntervalSeconds = 5;
+
+// Tab activity is sent to the ledger in batches, once per interval or as
+// soon as this many events are pending.
+const int kTabEventsFlushIntervalSeconds = 2;
+const size_t kMaxPendingTabEvents = 64;
+
 RewardsServiceImpl::RewardsServiceImpl(Profile* profile)
     : profile_(profile),
       bat_ledger_client_binding_(new bat_ledger::LedgerClientMojoProxy(this)),
@@ -279,6 +308,14 @@ RewardsServiceImpl::RewardsServiceImpl(Profile* profile)
       publisher_state_path_(profile_->GetPath().Append(kPublisher_state)),
       publisher_info_db_path_(profile->GetPath().Append(kPublisher_info_db)),
       publisher_list_path_(profile->GetPath().Append(kPublishers_list)),
+      ledger_state_writer_(
+          ledger_state_path_,
+          file_task_runner_,
+          base::TimeDelta::FromSeconds(kStateSaveIntervalSeconds)),
+      publisher_state_writer_(
+          publisher_state_path_,
+          file_task_runner_,
+          base::TimeDelta::FromSeconds(kStateSaveIntervalSeconds)),
       publisher_info_backend_(
           new PublisherInfoDatabase(publisher_info_db_path_)),
       notification_service_(new RewardsNotificationServiceImpl(profile)),
@@ -414,6 +451,9 @@ void RewardsServiceImpl::GetCurrentContributeList(
     return;
   }
 
+  // The list should include the time of the visits that are still pending.
+  FlushTabEvents();
+
   ledger::PublisherInfoFilter filter;
   filter.category = ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE;
   filter.month = ledger::PUBLISHER_MONTH::ANY;
@@ -427,7 +467,7 @@ void RewardsServiceImpl::GetCurrentContributeList(
   filter.non_verified = allow_non_verified;
 
   bat_ledger_->GetPublisherInfoList(start, limit,
-      filter.ToJson(),
+      filter,
       base::BindOnce(&RewardsServiceImpl::OnGetPublisherInfoList, AsWeakPtr(),
                 start,
                 limit,
@@ -437,17 +477,9 @@ void RewardsServiceImpl::GetCurrentContributeList(
 void RewardsServiceImpl::OnGetPublisherInfoList(
     uint32_t start, uint32_t limit,
     const GetCurrentContributeListCallback& callback,
-    const std::vector<std::string>& publisher_info_list,
+    const ledger::PublisherInfoList& publisher_info_list,
     uint32_t next_record) {
-  ledger::PublisherInfoList list;
-
-  for (const auto& i : publisher_info_list) {
-    ledger::PublisherInfo info;
-    info.loadFromJson(i);
-    list.push_back(info);
-  }
-
-  GetContentSiteListInternal(start, limit, callback, std::move(list),
+  GetContentSiteListInternal(start, limit, callback, publisher_info_list,
       next_record);
 }
 
@@ -475,56 +507,97 @@ void RewardsServiceImpl::OnLoad(SessionID tab_id, const GURL& url) {
                          publisher_url,
                          "",
                          "");
-  bat_ledger_->OnLoad(data.ToJson(), GetCurrentTimestamp());
+  ledger::TabEvent event(ledger::TAB_EVENT_TYPE::TAB_LOAD, tab_id.id(),
+      GetCurrentTimestamp());
+  event.visit_data = data;
+  QueueTabEvent(event);
 }
 
 void RewardsServiceImpl::OnUnload(SessionID tab_id) {
   if (!Connected())
     return;
 
-  bat_ledger_->OnUnload(tab_id.id(), GetCurrentTimestamp());
+  QueueTabEvent(ledger::TabEvent(ledger::TAB_EVENT_TYPE::TAB_UNLOAD,
+      tab_id.id(), GetCurrentTimestamp()));
 }
 
 void RewardsServiceImpl::OnShow(SessionID tab_id) {
   if (!Connected())
     return;
 
-  bat_ledger_->OnShow(tab_id.id(), GetCurrentTimestamp());
+  QueueTabEvent(ledger::TabEvent(ledger::TAB_EVENT_TYPE::TAB_SHOW,
+      tab_id.id(), GetCurrentTimestamp()));
 }
 
 void RewardsServiceImpl::OnHide(SessionID tab_id) {
   if (!Connected())
     return;
 
-  bat_ledger_->OnHide(tab_id.id(), GetCurrentTimestamp());
+  QueueTabEvent(ledger::TabEvent(ledger::TAB_EVENT_TYPE::TAB_HIDE,
+      tab_id.id(), GetCurrentTimestamp()));
 }
 
 void RewardsServiceImpl::OnForeground(SessionID tab_id) {
   if (!Connected())
     return;
 
-  bat_ledger_->OnForeground(tab_id.id(), GetCurrentTimestamp());
+  QueueTabEvent(ledger::TabEvent(ledger::TAB_EVENT_TYPE::TAB_FOREGROUND,
+      tab_id.id(), GetCurrentTimestamp()));
 }
 
 void RewardsServiceImpl::OnBackground(SessionID tab_id) {
   if (!Connected())
     return;
 
-  bat_ledger_->OnBackground(tab_id.id(), GetCurrentTimestamp());
+  QueueTabEvent(ledger::TabEvent(ledger::TAB_EVENT_TYPE::TAB_BACKGROUND,
+      tab_id.id(), GetCurrentTimestamp()));
 }
 
 void RewardsServiceImpl::OnMediaStart(SessionID tab_id) {
   if (!Connected())
     return;
 
-  bat_ledger_->OnMediaStart(tab_id.id(), GetCurrentTimestamp());
+  QueueTabEvent(ledger::TabEvent(ledger::TAB_EVENT_TYPE::TAB_MEDIA_START,
+      tab_id.id(), GetCurrentTimestamp()));
 }
 
 void RewardsServiceImpl::OnMediaStop(SessionID tab_id) {
   if (!Connected())
     return;
 
-  bat_ledger_->OnMediaStop(tab_id.id(), GetCurrentTimestamp());
+  QueueTabEvent(ledger::TabEvent(ledger::TAB_EVENT_TYPE::TAB_MEDIA_STOP,
+      tab_id.id(), GetCurrentTimestamp()));
+}
+
+void RewardsServiceImpl::QueueTabEvent(const ledger::TabEvent& event) {
+  pending_tab_events_.push_back(event);
+  if (pending_tab_events_.size() >= kMaxPendingTabEvents) {
+    FlushTabEvents();
+    return;
+  }
+
+  if (!tab_events_timer_)
+    tab_events_timer_ = std::make_unique<base::OneShotTimer>();
+
+  if (!tab_events_timer_->IsRunning()) {
+    tab_events_timer_->Start(FROM_HERE,
+        base::TimeDelta::FromSeconds(kTabEventsFlushIntervalSeconds),
+        base::BindOnce(&RewardsServiceImpl::FlushTabEvents, AsWeakPtr()));
+  }
+}
+
+void RewardsServiceImpl::FlushTabEvents() {
+  if (tab_events_timer_)
+    tab_events_timer_->Stop();
+
+  if (pending_tab_events_.empty())
+    return;
+
+  // The batch is serialized by the call, so clearing the buffer afterwards
+  // keeps its capacity for the next one.
+  if (Connected())
+    bat_ledger_->OnTabEvents(pending_tab_events_);
+  pending_tab_events_.clear();
 }
 
 void RewardsServiceImpl::OnPostData(SessionID tab_id,
@@ -546,6 +619,9 @@ void RewardsServiceImpl::OnPostData(SessionID tab_id,
   if (output.empty())
     return;
 
+  // Keeps the post after the tab activity that came before it.
+  FlushTabEvents();
+
   auto now = base::Time::Now();
   ledger::VisitData visit_data(
       "",
@@ -563,7 +639,7 @@ void RewardsServiceImpl::OnPostData(SessionID tab_id,
                           first_party_url.spec(),
                           referrer.spec(),
                           output,
-                          visit_data.ToJson());
+                          visit_data);
 }
 
 void RewardsServiceImpl::OnXHRLoad(SessionID tab_id,
@@ -580,16 +656,17 @@ void RewardsServiceImpl::OnXHRLoad(SessionID tab_id,
   }
 
   auto now = base::Time::Now();
-  ledger::VisitData data("", "", url.spec(), tab_id.id(),
-                         GetPublisherMonth(now), GetPublisherYear(now),
-                         "", "", "", "");
-
-  bat_ledger_->OnXHRLoad(tab_id.id(),
-                     url.spec(),
-                     mojo::MapToFlatMap(parts),
-                     first_party_url.spec(),
-                     referrer.spec(),
-                     data.ToJson());
+  ledger::TabEvent event(ledger::TAB_EVENT_TYPE::TAB_XHR_LOAD, tab_id.id(),
+      GetCurrentTimestamp());
+  event.visit_data = ledger::VisitData("", "", url.spec(), tab_id.id(),
+                                       GetPublisherMonth(now),
+                                       GetPublisherYear(now),
+                                       "", "", "", "");
+  event.url = url.spec();
+  event.parts = std::move(parts);
+  event.first_party_url = first_party_url.spec();
+  event.referrer = referrer.spec();
+  QueueTabEvent(event);
 }
 
 void RewardsServiceImpl::LoadMediaPublisherInfo(
@@ -676,11 +753,21 @@ void RewardsServiceImpl::Shutdown() {
   }
   fetchers_.clear();
 
+  FlushTabEvents();
   bat_ledger_.reset();
+  FlushState();
   RewardsService::Shutdown();
 }
 
+void RewardsServiceImpl::FlushState() {
+  ledger_state_writer_.Flush();
+  publisher_state_writer_.Flush();
+}
+
 void RewardsServiceImpl::OnWalletInitialized(ledger::Result result) {
+  // A new wallet must not be lost to a crash.
+  FlushState();
+
   if (!ready_.is_signaled())
     ready_.Signal();
 
@@ -739,11 +826,13 @@ void RewardsServiceImpl::OnGrantCaptcha(const std::string& image, const std::str
 void RewardsServiceImpl::OnRecoverWallet(ledger::Result result,
                                     double balance,
                                     const std::vector<ledger::Grant>& grants) {
+  FlushState();
   TriggerOnRecoverWallet(result, balance, grants);
 }
 
 void RewardsServiceImpl::OnGrantFinish(ledger::Result result,
                                        const ledger::Grant& grant) {
+  FlushState();
   ledger::BalanceReportInfo report_info;
   auto now = base::Time::Now();
   if (result == ledger::Result::LEDGER_OK) {
@@ -764,6 +853,10 @@ void RewardsServiceImpl::OnReconcileComplete(ledger::Result result,
   const std::string& viewing_id,
   ledger::PUBLISHER_CATEGORY category,
   const std::string& probi) {
+  // The reconcile is a checkpoint for the transactions and ballots saved
+  // while it ran.
+  FlushState();
+
   if (result == ledger::Result::LEDGER_OK) {
     auto now = base::Time::Now();
     if (!Connected())
@@ -790,7 +883,7 @@ void RewardsServiceImpl::OnReconcileComplete(ledger::Result result,
 void RewardsServiceImpl::LoadLedgerState(
     ledger::LedgerCallbackHandler* handler) {
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
-      base::Bind(&LoadStateOnFileTaskRunner, ledger_state_path_),
+      base::Bind(&LoadWrittenStateOnFileTaskRunner, ledger_state_path_),
       base::Bind(&RewardsServiceImpl::OnLedgerStateLoaded,
                      AsWeakPtr(),
                      base::Unretained(handler)));
@@ -813,7 +906,7 @@ void RewardsServiceImpl::OnLedgerStateLoaded(
 void RewardsServiceImpl::LoadPublisherState(
     ledger::LedgerCallbackHandler* handler) {
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
-      base::Bind(&LoadStateOnFileTaskRunner, publisher_state_path_),
+      base::Bind(&LoadWrittenStateOnFileTaskRunner, publisher_state_path_),
       base::Bind(&RewardsServiceImpl::OnPublisherStateLoaded,
                      AsWeakPtr(),
                      base::Unretained(handler)));
@@ -833,18 +926,10 @@ void RewardsServiceImpl::OnPublisherStateLoaded(
 
 void RewardsServiceImpl::SaveLedgerState(const std::string& ledger_state,
                                       ledger::LedgerCallbackHandler* handler) {
-  base::ImportantFileWriter writer(
-      ledger_state_path_, file_task_runner_);
-
-  writer.RegisterOnNextWriteCallbacks(
-      base::Closure(),
-      base::Bind(
-        &PostWriteCallback,
-        base::Bind(&RewardsServiceImpl::OnLedgerStateSaved, AsWeakPtr(),
-            base::Unretained(handler)),
-        base::SequencedTaskRunnerHandle::Get()));
-
-  writer.WriteNow(std::make_unique<std::string>(ledger_state));
+  ledger_state_writer_.Save(
+      ledger_state,
+      base::BindOnce(&RewardsServiceImpl::OnLedgerStateSaved, AsWeakPtr(),
+                     base::Unretained(handler)));
 }
 
 void RewardsServiceImpl::OnLedgerStateSaved(
@@ -859,17 +944,10 @@ void RewardsServiceImpl::OnLedgerStateSaved(
 
 void RewardsServiceImpl::SavePublisherState(const std::string& publisher_state,
                                       ledger::LedgerCallbackHandler* handler) {
-  base::ImportantFileWriter writer(publisher_state_path_, file_task_runner_);
-
-  writer.RegisterOnNextWriteCallbacks(
-      base::Closure(),
-      base::Bind(
-        &PostWriteCallback,
-        base::Bind(&RewardsServiceImpl::OnPublisherStateSaved, AsWeakPtr(),
-            base::Unretained(handler)),
-        base::SequencedTaskRunnerHandle::Get()));
-
-  writer.WriteNow(std::make_unique<std::string>(publisher_state));
+  publisher_state_writer_.Save(
+      publisher_state,
+      base::BindOnce(&RewardsServiceImpl::OnPublisherStateSaved, AsWeakPtr(),
+                     base::Unretained(handler)));
 }
 
 void RewardsServiceImpl::OnPublisherStateSaved(
@@ -925,6 +1003,29 @@ void RewardsServiceImpl::OnPublisherInfoSaved(
   TriggerOnContentSiteUpdated();
 }
 
+void RewardsServiceImpl::SavePublisherInfoList(
+    const ledger::PublisherInfoList& list,
+    ledger::SavePublisherInfoListCallback callback) {
+  base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
+      base::Bind(&SavePublisherInfoListOnFileTaskRunner,
+                    list,
+                    publisher_info_backend_.get()),
+      base::Bind(&RewardsServiceImpl::OnPublisherInfoListSaved,
+                     AsWeakPtr(),
+                     callback));
+}
+
+void RewardsServiceImpl::OnPublisherInfoListSaved(
+    ledger::SavePublisherInfoListCallback callback,
+    bool success) {
+  if (Connected()) {
+    callback(success ? ledger::Result::LEDGER_OK
+        : ledger::Result::LEDGER_ERROR);
+  }
+
+  TriggerOnContentSiteUpdated();
+}
+
 void RewardsServiceImpl::LoadPublisherInfo(
     ledger::PublisherInfoFilter filter,
     ledger::PublisherInfoCallback callback) {
@@ -1552,7 +1653,8 @@ void RewardsServiceImpl::GetPublisherActivityFromUrl(uint64_t windowId,
   visitData.url = origin.spec();
   visitData.favicon_url = favicon_url;
 
-  bat_ledger_->GetPublisherActivityFromUrl(windowId, visitData.ToJson());
+  FlushTabEvents();
+  bat_ledger_->GetPublisherActivityFromUrl(windowId, visitData);
 }
 
 void RewardsServiceImpl::OnExcludedSitesChanged(const std::string& publisher_id) {
@@ -1734,7 +1836,7 @@ void RewardsServiceImpl::OnDonate(const std::string& publisher_key, int amount,
     ledger::PUBLISHER_MONTH::ANY,
     -1);
 
-  bat_ledger_->DoDirectDonation(publisher.ToJson(), amount, "BAT");
+  bat_ledger_->DoDirectDonation(publisher, amount, "BAT");
 }
 
 bool SaveContributionInfoOnFileTaskRunner(const brave_rewards::ContributionInfo info,
@@ -2138,6 +2240,16 @@ bool RewardsServiceImpl::Connected() const {
   return bat_ledger_.is_bound();
 }
 
+void RewardsServiceImpl::SetBatLedgerForTesting(
+    bat_ledger::mojom::BatLedgerAssociatedPtr ledger) {
+  bat_ledger_ = std::move(ledger);
+}
+
+void RewardsServiceImpl::SetTabEventsTimerForTesting(
+    std::unique_ptr<base::OneShotTimer> timer) {
+  tab_events_timer_ = std::move(timer);
+}
+
 void RewardsServiceImpl::SetLedgerEnvForTesting() {
   bat_ledger_service_->SetTesting();
 
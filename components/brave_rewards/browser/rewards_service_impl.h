@@ -30,6 +30,7 @@
 #include "ui/gfx/image/image.h"
 #include "brave/components/brave_rewards/browser/publisher_banner.h"
 #include "brave/components/brave_rewards/browser/rewards_service_private_observer.h"
+#include "brave/components/brave_rewards/browser/state_writer.h"
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
 #include "brave/components/brave_rewards/browser/extension_rewards_service_observer.h"
@@ -166,6 +167,8 @@ class RewardsServiceImpl : public RewardsService,
 
   // Testing methods
   void SetLedgerEnvForTesting();
+  void SetBatLedgerForTesting(bat_ledger::mojom::BatLedgerAssociatedPtr ledger);
+  void SetTabEventsTimerForTesting(std::unique_ptr<base::OneShotTimer> timer);
 
  private:
   const extensions::OneShotEvent& ready() const { return ready_; }
@@ -190,6 +193,8 @@ class RewardsServiceImpl : public RewardsService,
   void OnPublisherInfoSaved(ledger::PublisherInfoCallback callback,
                             std::unique_ptr<ledger::PublisherInfo> info,
                             bool success);
+  void OnPublisherInfoListSaved(ledger::SavePublisherInfoListCallback callback,
+                                bool success);
   void OnPublisherInfoLoaded(ledger::PublisherInfoCallback callback,
                              const ledger::PublisherInfoList list);
   void OnMediaPublisherInfoSaved(bool success);
@@ -251,6 +256,9 @@ class RewardsServiceImpl : public RewardsService,
 
   void SavePublisherInfo(std::unique_ptr<ledger::PublisherInfo> publisher_info,
                          ledger::PublisherInfoCallback callback) override;
+  void SavePublisherInfoList(
+      const ledger::PublisherInfoList& list,
+      ledger::SavePublisherInfoListCallback callback) override;
   void LoadPublisherInfo(ledger::PublisherInfoFilter filter,
                          ledger::PublisherInfoCallback callback) override;
   void LoadPublisherInfoList(
@@ -320,7 +328,7 @@ class RewardsServiceImpl : public RewardsService,
   void OnPublisherBannerMojoProxy(const std::string& banner);
   void OnGetPublisherInfoList(uint32_t start, uint32_t limit,
       const GetCurrentContributeListCallback& callback,
-      const std::vector<std::string>& publisher_info_list,
+      const ledger::PublisherInfoList& publisher_info_list,
       uint32_t next_record);
   void OnGetAllBalanceReports(
       const GetAllBalanceReportsCallback& callback,
@@ -336,6 +344,12 @@ class RewardsServiceImpl : public RewardsService,
 
   bool Connected() const;
   void ConnectionClosed();
+  // Buffers tab activity for the ledger, see FlushTabEvents.
+  void QueueTabEvent(const ledger::TabEvent& event);
+  // Sends the buffered tab activity to the ledger in one message.
+  void FlushTabEvents();
+  // Writes any coalesced state right away, see StateWriter.
+  void FlushState();
 
   Profile* profile_;  // NOT OWNED
   mojo::AssociatedBinding<bat_ledger::mojom::BatLedgerClient>
@@ -352,6 +366,8 @@ class RewardsServiceImpl : public RewardsService,
   const base::FilePath publisher_state_path_;
   const base::FilePath publisher_info_db_path_;
   const base::FilePath publisher_list_path_;
+  StateWriter ledger_state_writer_;
+  StateWriter publisher_state_writer_;
   std::unique_ptr<PublisherInfoDatabase> publisher_info_backend_;
   std::unique_ptr<RewardsNotificationServiceImpl> notification_service_;
   base::ObserverList<RewardsServicePrivateObserver> private_observers_;
@@ -366,6 +382,8 @@ class RewardsServiceImpl : public RewardsService,
   std::vector<BitmapFetcherService::RequestId> request_ids_;
   std::unique_ptr<base::OneShotTimer> notification_startup_timer_;
   std::unique_ptr<base::RepeatingTimer> notification_periodic_timer_;
+  ledger::TabEventList pending_tab_events_;
+  std::unique_ptr<base::OneShotTimer> tab_events_timer_;
 
   uint32_t next_timer_id_;
 
@@ -3,15 +3,25 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "base/files/scoped_temp_dir.h"
+#include "base/logging.h"
+#include "base/test/test_mock_time_task_runner.h"
+#include "base/timer/timer.h"
 #include "brave/components/brave_rewards/browser/wallet_properties.h"
 #include "brave/components/brave_rewards/browser/rewards_service_factory.h"
 #include "brave/components/brave_rewards/browser/rewards_service_impl.h"
 #include "brave/components/brave_rewards/browser/rewards_service_observer.h"
 #include "brave/components/brave_rewards/browser/test_util.h"
+#include "brave/components/services/bat_ledger/public/interfaces/bat_ledger.mojom-test-utils.h"
 #include "chrome/browser/profiles/profile.h"
+#include "components/sessions/core/session_id.h"
 #include "content/public/test/test_browser_thread_bundle.h"
+#include "content/public/test/test_utils.h"
+#include "mojo/public/cpp/bindings/associated_binding.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -54,6 +64,49 @@ class MockRewardsServiceObserver : public RewardsServiceObserver {
       void(RewardsService*, int, ledger::PublisherInfo*, uint64_t));
 };
 
+// Records the calls the rewards service makes into the ledger, in order.
+class FakeBatLedger : public bat_ledger::mojom::BatLedgerInterceptorForTesting {
+ public:
+  FakeBatLedger() {}
+
+  bat_ledger::mojom::BatLedger* GetForwardingInterface() override {
+    NOTREACHED();
+    return nullptr;
+  }
+
+  void OnTabEvents(const ledger::TabEventList& events) override {
+    calls_.push_back("OnTabEvents");
+    batches_.push_back(events);
+  }
+
+  void OnPostData(const std::string& url,
+                  const std::string& first_party_url,
+                  const std::string& referrer,
+                  const std::string& post_data,
+                  const ledger::VisitData& visit_data) override {
+    calls_.push_back("OnPostData");
+  }
+
+  void GetPublisherInfoList(uint32_t start,
+                            uint32_t limit,
+                            const ledger::PublisherInfoFilter& filter,
+                            GetPublisherInfoListCallback callback) override {
+    calls_.push_back("GetPublisherInfoList");
+    std::move(callback).Run(ledger::PublisherInfoList(), 0);
+  }
+
+  const std::vector<std::string>& calls() const { return calls_; }
+  const std::vector<ledger::TabEventList>& batches() const {
+    return batches_;
+  }
+
+ private:
+  std::vector<std::string> calls_;
+  std::vector<ledger::TabEventList> batches_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeBatLedger);
+};
+
 class RewardsServiceTest : public testing::Test {
  public:
   RewardsServiceTest() {}
@@ -81,6 +134,28 @@ class RewardsServiceTest : public testing::Test {
   RewardsServiceImpl* rewards_service() { return rewards_service_; }
   MockRewardsServiceObserver* observer() { return observer_.get(); }
 
+  // Sends the ledger calls to |bat_ledger_| and times tab event batches on
+  // |timer_task_runner_|.
+  void UseFakeBatLedger() {
+    bat_ledger::mojom::BatLedgerAssociatedPtr bat_ledger_ptr;
+    bat_ledger_binding_.reset(
+        new mojo::AssociatedBinding<bat_ledger::mojom::BatLedger>(
+            &bat_ledger_,
+            mojo::MakeRequestAssociatedWithDedicatedPipe(&bat_ledger_ptr)));
+    rewards_service_->SetBatLedgerForTesting(std::move(bat_ledger_ptr));
+
+    timer_task_runner_ = new base::TestMockTimeTaskRunner();
+    auto timer = std::make_unique<base::OneShotTimer>(
+        timer_task_runner_->GetMockTickClock());
+    timer->SetTaskRunner(timer_task_runner_);
+    rewards_service_->SetTabEventsTimerForTesting(std::move(timer));
+  }
+
+  const FakeBatLedger& bat_ledger() const { return bat_ledger_; }
+  base::TestMockTimeTaskRunner* timer_task_runner() {
+    return timer_task_runner_.get();
+  }
+
  private:
   // Need this as a very first member to run tests in UI thread
   // When this is set, class should not install any other MessageLoops, like
@@ -90,6 +165,10 @@ class RewardsServiceTest : public testing::Test {
   RewardsServiceImpl* rewards_service_;
   std::unique_ptr<MockRewardsServiceObserver> observer_;
   base::ScopedTempDir temp_dir_;
+  FakeBatLedger bat_ledger_;
+  std::unique_ptr<mojo::AssociatedBinding<bat_ledger::mojom::BatLedger>>
+      bat_ledger_binding_;
+  scoped_refptr<base::TestMockTimeTaskRunner> timer_task_runner_;
 };
 
 TEST_F(RewardsServiceTest, OnWalletProperties) {
@@ -98,4 +177,80 @@ TEST_F(RewardsServiceTest, OnWalletProperties) {
   rewards_service()->OnWalletProperties(ledger::Result::LEDGER_ERROR, nullptr);
 }
 
+TEST_F(RewardsServiceTest, SendsTabEventsWhenTimerFires) {
+  UseFakeBatLedger();
+  const SessionID tab_id = SessionID::FromSerializedValue(1);
+  rewards_service()->OnShow(tab_id);
+  rewards_service()->OnHide(tab_id);
+  rewards_service()->OnBackground(tab_id);
+
+  timer_task_runner()->FastForwardBy(
+      base::TimeDelta::FromMilliseconds(1999));
+  content::RunAllTasksUntilIdle();
+  EXPECT_TRUE(bat_ledger().batches().empty());
+
+  timer_task_runner()->FastForwardBy(base::TimeDelta::FromMilliseconds(1));
+  content::RunAllTasksUntilIdle();
+  ASSERT_EQ(bat_ledger().batches().size(), 1u);
+  const ledger::TabEventList& batch = bat_ledger().batches()[0];
+  ASSERT_EQ(batch.size(), 3u);
+  EXPECT_EQ(batch[0].type, ledger::TAB_EVENT_TYPE::TAB_SHOW);
+  EXPECT_EQ(batch[1].type, ledger::TAB_EVENT_TYPE::TAB_HIDE);
+  EXPECT_EQ(batch[2].type, ledger::TAB_EVENT_TYPE::TAB_BACKGROUND);
+  EXPECT_EQ(batch[0].tab_id, 1u);
+}
+
+TEST_F(RewardsServiceTest, SendsFullTabEventBatchRightAway) {
+  UseFakeBatLedger();
+  const SessionID tab_id = SessionID::FromSerializedValue(1);
+  for (int i = 0; i < 65; ++i)
+    rewards_service()->OnShow(tab_id);
+
+  content::RunAllTasksUntilIdle();
+  ASSERT_EQ(bat_ledger().batches().size(), 1u);
+  EXPECT_EQ(bat_ledger().batches()[0].size(), 64u);
+
+  // The event past the full batch waits for the timer.
+  timer_task_runner()->FastForwardBy(base::TimeDelta::FromSeconds(2));
+  content::RunAllTasksUntilIdle();
+  ASSERT_EQ(bat_ledger().batches().size(), 2u);
+  EXPECT_EQ(bat_ledger().batches()[1].size(), 1u);
+}
+
+TEST_F(RewardsServiceTest, FlushesTabEventsBeforePostData) {
+  UseFakeBatLedger();
+  const SessionID tab_id = SessionID::FromSerializedValue(1);
+  rewards_service()->OnHide(tab_id);
+  rewards_service()->OnPostData(tab_id,
+                                GURL("https://www.youtube.com/api/stats"),
+                                GURL("https://www.youtube.com/"),
+                                GURL(),
+                                "docid=a&st=0&et=10");
+
+  content::RunAllTasksUntilIdle();
+  EXPECT_EQ(bat_ledger().calls(),
+            std::vector<std::string>({"OnTabEvents", "OnPostData"}));
+}
+
+TEST_F(RewardsServiceTest, FlushesTabEventsBeforeContributeList) {
+  UseFakeBatLedger();
+  rewards_service()->OnHide(SessionID::FromSerializedValue(1));
+  rewards_service()->GetCurrentContributeList(0, 0, 0, 0, true,
+      base::Bind([](std::unique_ptr<ContentSiteList>, uint32_t) {}));
+
+  content::RunAllTasksUntilIdle();
+  EXPECT_EQ(bat_ledger().calls(),
+            std::vector<std::string>({"OnTabEvents", "GetPublisherInfoList"}));
+}
+
+TEST_F(RewardsServiceTest, FlushesTabEventsOnShutdown) {
+  UseFakeBatLedger();
+  rewards_service()->OnHide(SessionID::FromSerializedValue(1));
+  rewards_service()->Shutdown();
+
+  content::RunAllTasksUntilIdle();
+  ASSERT_EQ(bat_ledger().batches().size(), 1u);
+  EXPECT_EQ(bat_ledger().batches()[0].size(), 1u);
+}
+
 // add test for strange entries
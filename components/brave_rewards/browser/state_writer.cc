@@ -0,0 +1,261 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/state_writer.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/hash.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_runner_util.h"
+
+namespace brave_rewards {
+
+namespace {
+
+// Journal layout, all integers are uint32_t in host byte order:
+//   header:  magic, hash and size of the file it applies to
+//   records: hash of the state before and after, prefix size, suffix size,
+//            middle size, middle bytes
+// A record replaces everything between the first |prefix| and the last
+// |suffix| bytes of the state with the middle bytes. Replay stops at the
+// first record that does not follow from the previous one, which is where
+// a write was cut short.
+const char kJournalMagic[4] = {'B', 'R', 'S', 'J'};
+const size_t kJournalHeaderSize = sizeof(kJournalMagic) + 2 * sizeof(uint32_t);
+const size_t kRecordHeaderSize = 5 * sizeof(uint32_t);
+// Bounds the work of replaying the journal on load.
+const size_t kMaxJournalRecords = 64;
+
+uint32_t ReadUInt32(const char* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+void AppendUInt32(uint32_t value, std::string* output) {
+  output->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+base::FilePath GetJournalPath(const base::FilePath& path) {
+  return path.AddExtension(FILE_PATH_LITERAL("journal"));
+}
+
+std::string GetJournalHeader(const std::string& data, uint32_t hash) {
+  std::string header(kJournalMagic, sizeof(kJournalMagic));
+  AppendUInt32(hash, &header);
+  AppendUInt32(data.size(), &header);
+  return header;
+}
+
+// Describes |data| as |base| with the bytes between their common prefix and
+// common suffix replaced.
+std::string GetJournalRecord(const std::string& base,
+                             uint32_t base_hash,
+                             const std::string& data,
+                             uint32_t hash) {
+  const size_t max_common = std::min(base.size(), data.size());
+  const size_t prefix =
+      std::mismatch(data.begin(), data.begin() + max_common, base.begin())
+          .first - data.begin();
+  const size_t suffix =
+      std::mismatch(data.rbegin(), data.rbegin() + (max_common - prefix),
+                    base.rbegin())
+          .first - data.rbegin();
+  const size_t middle = data.size() - prefix - suffix;
+
+  std::string record;
+  record.reserve(kRecordHeaderSize + middle);
+  AppendUInt32(base_hash, &record);
+  AppendUInt32(hash, &record);
+  AppendUInt32(prefix, &record);
+  AppendUInt32(suffix, &record);
+  AppendUInt32(middle, &record);
+  record.append(data, prefix, middle);
+  return record;
+}
+
+// Leaves |data| unchanged unless |journal| applies to it.
+void ApplyJournal(const std::string& journal, std::string* data) {
+  if (journal.size() < kJournalHeaderSize ||
+      memcmp(journal.data(), kJournalMagic, sizeof(kJournalMagic)) != 0 ||
+      ReadUInt32(journal.data() + 8) != data->size()) {
+    return;
+  }
+  uint32_t hash = ReadUInt32(journal.data() + 4);
+  if (base::PersistentHash(*data) != hash) {
+    return;
+  }
+
+  std::string state = *data;
+  size_t offset = kJournalHeaderSize;
+  while (journal.size() - offset >= kRecordHeaderSize) {
+    const char* record = journal.data() + offset;
+    const uint32_t prefix = ReadUInt32(record + 8);
+    const uint32_t suffix = ReadUInt32(record + 12);
+    const uint32_t middle = ReadUInt32(record + 16);
+    if (ReadUInt32(record) != hash ||
+        static_cast<uint64_t>(prefix) + suffix > state.size() ||
+        middle > journal.size() - offset - kRecordHeaderSize) {
+      break;
+    }
+    state.replace(prefix, state.size() - prefix - suffix,
+                  record + kRecordHeaderSize, middle);
+    hash = ReadUInt32(record + 4);
+    offset += kRecordHeaderSize + middle;
+  }
+
+  // Records only carry the hash of their result, so check it once at the end.
+  if (base::PersistentHash(state) == hash) {
+    data->swap(state);
+  }
+}
+
+bool WriteSnapshot(const base::FilePath& path,
+                   const std::string& data,
+                   const std::string& journal_header) {
+  // If the journal can't be reset after the file is replaced, its header no
+  // longer matches the file and it is ignored on load.
+  return base::ImportantFileWriter::WriteFileAtomically(path, data) &&
+      base::WriteFile(GetJournalPath(path), journal_header.data(),
+                      journal_header.size()) ==
+          static_cast<int>(journal_header.size());
+}
+
+bool AppendToJournal(const base::FilePath& path,
+                     const std::string& journal_header,
+                     const std::string& record) {
+  base::File file(GetJournalPath(path),
+                  base::File::FLAG_OPEN | base::File::FLAG_READ |
+                      base::File::FLAG_APPEND);
+  if (!file.IsValid()) {
+    return false;
+  }
+  // Don't extend a journal that belongs to another write of the file.
+  char header[kJournalHeaderSize];
+  if (file.Read(0, header, sizeof(header)) != static_cast<int>(sizeof(header)) ||
+      journal_header.compare(0, std::string::npos, header, sizeof(header)) !=
+          0) {
+    return false;
+  }
+  return file.WriteAtCurrentPos(record.data(), record.size()) ==
+      static_cast<int>(record.size());
+}
+
+void RunSaveCallbacks(std::vector<StateWriter::SaveCallback> callbacks,
+                      bool success) {
+  for (auto& callback : callbacks)
+    std::move(callback).Run(success);
+}
+
+}  // namespace
+
+StateWriter::StateWriter(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> file_task_runner,
+    base::TimeDelta interval)
+    : path_(path),
+      file_task_runner_(std::move(file_task_runner)),
+      interval_(interval),
+      written_hash_(0),
+      journal_size_(0),
+      journal_records_(0),
+      needs_snapshot_(true),
+      weak_factory_(this) {
+}
+
+StateWriter::~StateWriter() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  Flush();
+}
+
+// static
+bool StateWriter::ReadState(const base::FilePath& path, std::string* data) {
+  if (!base::ReadFileToString(path, data)) {
+    return false;
+  }
+  std::string journal;
+  if (base::ReadFileToString(GetJournalPath(path), &journal)) {
+    ApplyJournal(journal, data);
+  }
+  return true;
+}
+
+void StateWriter::Save(const std::string& data, SaveCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  pending_data_ = data;
+  pending_callbacks_.push_back(std::move(callback));
+  if (!timer_.IsRunning()) {
+    timer_.Start(FROM_HERE, interval_,
+                 base::BindRepeating(&StateWriter::Flush,
+                                     base::Unretained(this)));
+  }
+}
+
+void StateWriter::Flush() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  timer_.Stop();
+  if (pending_callbacks_.empty()) {
+    return;
+  }
+
+  std::vector<SaveCallback> callbacks;
+  callbacks.swap(pending_callbacks_);
+  std::string data;
+  data.swap(pending_data_);
+  const uint32_t hash = base::PersistentHash(data);
+
+  std::string record;
+  if (!needs_snapshot_ && journal_records_ < kMaxJournalRecords) {
+    record = GetJournalRecord(written_data_, written_hash_, data, hash);
+  }
+  if (!record.empty() && journal_size_ + record.size() <= data.size()) {
+    journal_size_ += record.size();
+    ++journal_records_;
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::BindOnce(&AppendToJournal, path_, journal_header_,
+                       std::move(record)),
+        base::BindOnce(&StateWriter::OnWriteDone, weak_factory_.GetWeakPtr(),
+                       std::move(callbacks)));
+  } else {
+    journal_header_ = GetJournalHeader(data, hash);
+    journal_size_ = kJournalHeaderSize;
+    journal_records_ = 0;
+    needs_snapshot_ = false;
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::BindOnce(&WriteSnapshot, path_, data, journal_header_),
+        base::BindOnce(&StateWriter::OnWriteDone, weak_factory_.GetWeakPtr(),
+                       std::move(callbacks)));
+  }
+  written_data_.swap(data);
+  written_hash_ = hash;
+}
+
+bool StateWriter::HasPendingWrite() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return !pending_callbacks_.empty();
+}
+
+// static
+void StateWriter::OnWriteDone(base::WeakPtr<StateWriter> writer,
+                              std::vector<SaveCallback> callbacks,
+                              bool success) {
+  // Records appended after a failed write don't follow from what is on disk
+  // and are skipped on load, so start over from a full write.
+  if (!success && writer) {
+    writer->needs_snapshot_ = true;
+  }
+  RunSaveCallbacks(std::move(callbacks), success);
+}
+
+}  // namespace brave_rewards
@@ -0,0 +1,93 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_STATE_WRITER_H_
+#define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_STATE_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace base {
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace brave_rewards {
+
+// Coalesces saves of a ledger state file. Each Save() replaces the pending
+// data, and the file is written once per |interval| at most, so a burst of
+// saves during a reconcile costs a single write. Flush() writes the pending
+// data right away and is used at checkpoints; destruction flushes too.
+//
+// Most saves only touch the ballots, batch votes or transactions, so a write
+// appends the changed bytes to a journal next to the file instead of
+// rewriting it. The file is rewritten, and the journal reset, once the
+// journal grows past the size of the state. Use ReadState() to load what was
+// written.
+class StateWriter {
+ public:
+  using SaveCallback = base::OnceCallback<void(bool success)>;
+
+  StateWriter(const base::FilePath& path,
+              scoped_refptr<base::SequencedTaskRunner> file_task_runner,
+              base::TimeDelta interval);
+  ~StateWriter();
+
+  // Reads the state written by a StateWriter for |path|, replaying its
+  // journal. Blocking, so call it on the file task runner.
+  static bool ReadState(const base::FilePath& path, std::string* data);
+
+  // |callback| runs on the calling sequence once |data|, or data saved after
+  // it, has been written.
+  void Save(const std::string& data, SaveCallback callback);
+
+  void Flush();
+
+  bool HasPendingWrite() const;
+
+ private:
+  static void OnWriteDone(base::WeakPtr<StateWriter> writer,
+                          std::vector<SaveCallback> callbacks,
+                          bool success);
+
+  const base::FilePath path_;
+  const scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  const base::TimeDelta interval_;
+  base::OneShotTimer timer_;
+
+  std::string pending_data_;
+  std::vector<SaveCallback> pending_callbacks_;
+
+  // The state as of the last write, which the next journal record is
+  // computed against.
+  std::string written_data_;
+  uint32_t written_hash_;
+  // Identifies the file the journal applies to.
+  std::string journal_header_;
+  size_t journal_size_;
+  size_t journal_records_;
+  // Set when a write failed, so the next one rewrites the file.
+  bool needs_snapshot_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<StateWriter> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(StateWriter);
+};
+
+}  // namespace brave_rewards
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_STATE_WRITER_H_
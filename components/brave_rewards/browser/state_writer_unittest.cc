@@ -0,0 +1,187 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/state_writer.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=StateWriterTest.*
+
+namespace brave_rewards {
+
+namespace {
+
+void OnSaved(int* saved, bool success) {
+  EXPECT_TRUE(success);
+  ++*saved;
+}
+
+// Big enough for small changes to go to the journal.
+std::string LargeState() {
+  std::string state;
+  for (int i = 0; i < 1000; ++i)
+    state.append(std::to_string(i));
+  return state;
+}
+
+}  // namespace
+
+class StateWriterTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("ledger_state");
+  }
+
+  std::string ReadState() {
+    std::string data;
+    base::ReadFileToString(path_, &data);
+    return data;
+  }
+
+  std::string ReadJournaledState() {
+    std::string data;
+    EXPECT_TRUE(StateWriter::ReadState(path_, &data));
+    return data;
+  }
+
+  base::FilePath journal_path() const {
+    return path_.AddExtension(FILE_PATH_LITERAL("journal"));
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+};
+
+TEST_F(StateWriterTest, CoalescesSaves) {
+  int saved = 0;
+  StateWriter writer(path_, base::SequencedTaskRunnerHandle::Get(),
+                     base::TimeDelta::FromHours(1));
+  writer.Save("first", base::BindOnce(&OnSaved, &saved));
+  writer.Save("second", base::BindOnce(&OnSaved, &saved));
+  EXPECT_TRUE(writer.HasPendingWrite());
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(path_));
+  EXPECT_EQ(saved, 0);
+
+  writer.Flush();
+  EXPECT_FALSE(writer.HasPendingWrite());
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ(ReadState(), "second");
+  EXPECT_EQ(saved, 2);
+}
+
+TEST_F(StateWriterTest, FlushesOnDestruction) {
+  int saved = 0;
+  {
+    StateWriter writer(path_, base::SequencedTaskRunnerHandle::Get(),
+                       base::TimeDelta::FromHours(1));
+    writer.Save("state", base::BindOnce(&OnSaved, &saved));
+  }
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ(ReadState(), "state");
+  EXPECT_EQ(saved, 1);
+}
+
+TEST_F(StateWriterTest, JournalsSmallChanges) {
+  int saved = 0;
+  const std::string initial = LargeState();
+  StateWriter writer(path_, base::SequencedTaskRunnerHandle::Get(),
+                     base::TimeDelta::FromHours(1));
+  writer.Save(initial, base::BindOnce(&OnSaved, &saved));
+  writer.Flush();
+  scoped_task_environment_.RunUntilIdle();
+  int64_t journal_size = 0;
+  ASSERT_TRUE(base::GetFileSize(journal_path(), &journal_size));
+
+  std::string state = initial;
+  state.insert(1000, "ballot");
+  writer.Save(state, base::BindOnce(&OnSaved, &saved));
+  writer.Flush();
+  state.append("transaction");
+  writer.Save(state, base::BindOnce(&OnSaved, &saved));
+  writer.Flush();
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ(saved, 3);
+
+  // The file is untouched and the journal only grew by the changes.
+  EXPECT_EQ(ReadState(), initial);
+  int64_t new_journal_size = 0;
+  ASSERT_TRUE(base::GetFileSize(journal_path(), &new_journal_size));
+  EXPECT_LT(new_journal_size - journal_size, 100);
+  EXPECT_EQ(ReadJournaledState(), state);
+}
+
+TEST_F(StateWriterTest, RewritesFileForLargeChanges) {
+  int saved = 0;
+  StateWriter writer(path_, base::SequencedTaskRunnerHandle::Get(),
+                     base::TimeDelta::FromHours(1));
+  writer.Save(LargeState(), base::BindOnce(&OnSaved, &saved));
+  writer.Flush();
+  std::string state = LargeState();
+  std::reverse(state.begin(), state.end());
+  writer.Save(state, base::BindOnce(&OnSaved, &saved));
+  writer.Flush();
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ(saved, 2);
+  EXPECT_EQ(ReadState(), state);
+  EXPECT_EQ(ReadJournaledState(), state);
+}
+
+TEST_F(StateWriterTest, IgnoresJournalOfOtherFile) {
+  int saved = 0;
+  {
+    StateWriter writer(path_, base::SequencedTaskRunnerHandle::Get(),
+                       base::TimeDelta::FromHours(1));
+    writer.Save(LargeState(), base::BindOnce(&OnSaved, &saved));
+    writer.Flush();
+    writer.Save(LargeState() + "change", base::BindOnce(&OnSaved, &saved));
+  }
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ(saved, 2);
+  EXPECT_EQ(ReadJournaledState(), LargeState() + "change");
+
+  // As left by a crash between replacing the file and resetting the journal.
+  const std::string other = "other";
+  ASSERT_EQ(base::WriteFile(path_, other.data(), other.size()),
+            static_cast<int>(other.size()));
+  EXPECT_EQ(ReadJournaledState(), other);
+}
+
+TEST_F(StateWriterTest, StopsAtTornJournalRecord) {
+  int saved = 0;
+  const std::string first = LargeState() + "first";
+  {
+    StateWriter writer(path_, base::SequencedTaskRunnerHandle::Get(),
+                       base::TimeDelta::FromHours(1));
+    writer.Save(LargeState(), base::BindOnce(&OnSaved, &saved));
+    writer.Flush();
+    writer.Save(first, base::BindOnce(&OnSaved, &saved));
+    writer.Flush();
+    writer.Save(first + "second", base::BindOnce(&OnSaved, &saved));
+  }
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ(saved, 3);
+
+  // Cut the last record short, as a crash in the middle of an append would.
+  int64_t journal_size = 0;
+  ASSERT_TRUE(base::GetFileSize(journal_path(), &journal_size));
+  base::File journal(journal_path(),
+                     base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  ASSERT_TRUE(journal.SetLength(journal_size - 3));
+  journal.Close();
+  EXPECT_EQ(ReadJournaledState(), first);
+}
+
+}  // namespace brave_rewards
@@ -16,6 +16,7 @@
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task_runner_util.h"
 #include "base/threading/thread_restrictions.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
 #include "brave/vendor/ad-block/ad_block_client.h"
@@ -96,9 +97,7 @@ namespace brave_shields {
 
 AdBlockBaseService::AdBlockBaseService()
     : BaseBraveShieldsService(),
-      ad_block_client_(new AdBlockClient()),
       weak_factory_(this) {
-  DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 AdBlockBaseService::~AdBlockBaseService() {
@@ -106,15 +105,35 @@ AdBlockBaseService::~AdBlockBaseService() {
 }
 
 void AdBlockBaseService::Cleanup() {
-  ad_block_client_.reset();
+  scoped_refptr<DATFileClient<AdBlockClient>> old_ad_block_client;
+  {
+    base::AutoLock lock(ad_block_client_lock_);
+    old_ad_block_client = std::move(ad_block_client_);
+  }
+  // Released outside of the lock, the client is destroyed on the task runner
+  // which loaded it.
+}
+
+scoped_refptr<DATFileClient<AdBlockClient>>
+AdBlockBaseService::GetAdBlockClient() {
+  base::AutoLock lock(ad_block_client_lock_);
+  return ad_block_client_;
 }
 
 bool AdBlockBaseService::ShouldStartRequest(const GURL& url,
     content::ResourceType resource_type,
     const std::string& tab_host) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  scoped_refptr<DATFileClient<AdBlockClient>> ad_block_client =
+      GetAdBlockClient();
+  if (!ad_block_client) {
+    return true;
+  }
+  DATFileClient<AdBlockClient>::ScopedClient client(ad_block_client.get());
+  if (!client) {
+    return true;
+  }
   FilterOption current_option = ResourceTypeToFilterOption(resource_type);
-  if (ad_block_client_->matches(url.spec().c_str(),
+  if (client->matches(url.spec().c_str(),
         current_option,
         tab_host.c_str())) {
     // LOG(ERROR) << "AdBlockBaseService::ShouldStartRequest(), host: " << tab_host
@@ -127,23 +146,28 @@ bool AdBlockBaseService::ShouldStartRequest(const GURL& url,
 }
 
 void AdBlockBaseService::GetDATFileData(const base::FilePath& dat_file_path) {
-  GetTaskRunner()->PostTaskAndReply(
+  // The new list is built and validated on the task runner, off to the side
+  // of the one in use, and only published once it is complete.
+  base::PostTaskAndReplyWithResult(
+      GetTaskRunner().get(),
       FROM_HERE,
-      base::Bind(&brave_shields::GetDATFileData, dat_file_path, &buffer_),
-      base::Bind(&AdBlockBaseService::OnDATFileDataReady,
-                 weak_factory_.GetWeakPtr()));
+      base::BindOnce(&LoadDATFileClient<AdBlockClient>, dat_file_path),
+      base::BindOnce(&AdBlockBaseService::OnDATFileDataReady,
+                     weak_factory_.GetWeakPtr()));
 }
 
-void AdBlockBaseService::OnDATFileDataReady() {
-  if (buffer_.empty()) {
-    LOG(ERROR) << "Could not obtain ad block data";
+void AdBlockBaseService::OnDATFileDataReady(
+    scoped_refptr<DATFileClient<AdBlockClient>> ad_block_client) {
+  if (!ad_block_client) {
+    // Keep matching against the previous list, if any.
+    LOG(ERROR) << "Could not load ad block data";
     return;
   }
-  ad_block_client_.reset(new AdBlockClient());
-  if (!ad_block_client_->deserialize((char*)&buffer_.front())) {
-    ad_block_client_.reset();
-    LOG(ERROR) << "Failed to deserialize ad block data";
-    return;
+  // Requests being matched against the previous list keep their own
+  // reference to it. Ours is released outside of the lock.
+  {
+    base::AutoLock lock(ad_block_client_lock_);
+    ad_block_client_.swap(ad_block_client);
   }
 }
 
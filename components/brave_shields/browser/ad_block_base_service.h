@@ -13,7 +13,7 @@
 
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
-#include "base/sequence_checker.h"
+#include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
 #include "content/public/common/resource_type.h"
@@ -29,6 +29,8 @@ class AdBlockBaseService : public BaseBraveShieldsService {
   AdBlockBaseService();
   ~AdBlockBaseService() override;
 
+  // Can be called from any thread: matching runs against the filter list
+  // loaded when the call started.
   bool ShouldStartRequest(const GURL &url,
     content::ResourceType resource_type,
     const std::string& tab_host) override;
@@ -39,13 +41,15 @@ class AdBlockBaseService : public BaseBraveShieldsService {
 
   void GetDATFileData(const base::FilePath& dat_file_path);
 
-  std::unique_ptr<AdBlockClient> ad_block_client_;
-  DATFileDataBuffer buffer_;
-
  private:
-  void OnDATFileDataReady();
+  void OnDATFileDataReady(
+      scoped_refptr<DATFileClient<AdBlockClient>> ad_block_client);
+  scoped_refptr<DATFileClient<AdBlockClient>> GetAdBlockClient();
+
+  // Replaced as a whole when a new list is loaded.
+  scoped_refptr<DATFileClient<AdBlockClient>> ad_block_client_;
+  base::Lock ad_block_client_lock_;
 
-  SEQUENCE_CHECKER(sequence_checker_);
   base::WeakPtrFactory<AdBlockBaseService> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(AdBlockBaseService);
 };
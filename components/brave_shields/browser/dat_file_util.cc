@@ -4,13 +4,17 @@
 
 #include "brave/components/brave_shields/browser/dat_file_util.h"
 
+#include <memory>
+#include <utility>
+
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/logging.h"
 
 namespace brave_shields {
 
 void GetDATFileData(const base::FilePath& file_path,
-                    DATFileDataBuffer* buffer) {
+                    DATFileData* data) {
   int64_t size = 0;
   if (!base::PathExists(file_path) ||
       !base::GetFileSize(file_path, &size) ||
@@ -21,11 +25,14 @@ void GetDATFileData(const base::FilePath& file_path,
     return;
   }
 
-  buffer->resize(size);
-  if (size != base::ReadFile(file_path, (char*)&buffer->front(), size)) {
+  std::unique_ptr<base::MemoryMappedFile> mapped_file(
+      new base::MemoryMappedFile());
+  if (!mapped_file->Initialize(file_path)) {
     LOG(ERROR) << "GetDATFileData: cannot "
-               << "read dat file " << file_path;
+               << "map dat file " << file_path;
+    return;
   }
+  *data = std::move(mapped_file);
 }
 
 }  // namespace brave_shields
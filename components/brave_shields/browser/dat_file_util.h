@@ -5,9 +5,17 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_DAT_FILE_UTIL_H_
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_DAT_FILE_UTIL_H_
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/callback_forward.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_delete_on_sequence.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 
 namespace base {
 class FilePath;
@@ -15,10 +23,127 @@ class FilePath;
 
 namespace brave_shields {
 
-using DATFileDataBuffer = std::vector<unsigned char>;
+// Read-only mapping of a DAT file. The pages are backed by the page cache
+// and shared between processes instead of being copied to the heap.
+using DATFileData = std::unique_ptr<base::MemoryMappedFile>;
 
 void GetDATFileData(const base::FilePath& file_path,
-                    DATFileDataBuffer* buffer);
+                    DATFileData* data);
+
+// Clients deserialized from a DAT file, kept together with the mapping they
+// point into. A reference can be taken under a lock and then used from any
+// thread through a ScopedClient.
+//
+// The vendored clients have no const matching methods and nothing shows
+// that they are reentrant, so each thread matching at the same time gets a
+// client of its own. All of them are deserialized over the same mapping, and
+// they are kept for reuse, so there are never more of them than threads that
+// matched at once.
+//
+// Unmapping the file blocks, so the clients are always destroyed on the
+// sequence which created them, whichever thread drops the last reference.
+template <class T>
+class DATFileClient
+    : public base::RefCountedDeleteOnSequence<DATFileClient<T>> {
+ public:
+  // Borrows a client for the current thread. |dat_file_client| must outlive
+  // it. Deserializing a new client touches the mapping, so this may block.
+  class ScopedClient {
+   public:
+    explicit ScopedClient(DATFileClient<T>* dat_file_client)
+        : dat_file_client_(dat_file_client),
+          client_(dat_file_client->TakeClient()) {}
+    ~ScopedClient() {
+      if (client_) {
+        dat_file_client_->ReturnClient(std::move(client_));
+      }
+    }
+
+    // Null in the unlikely case a new client could not be deserialized.
+    T* get() const { return client_.get(); }
+    T* operator->() const { return client_.get(); }
+    explicit operator bool() const { return !!client_; }
+
+   private:
+    DATFileClient<T>* const dat_file_client_;
+    std::unique_ptr<T> client_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedClient);
+  };
+
+  // Returns nullptr if |data| cannot be deserialized. Must be called on a
+  // sequence which may block.
+  static scoped_refptr<DATFileClient<T>> Create(DATFileData data) {
+    if (!data || !data->IsValid() || data->length() == 0) {
+      return nullptr;
+    }
+    scoped_refptr<DATFileClient<T>> dat_file_client(
+        new DATFileClient<T>(std::move(data)));
+    std::unique_ptr<T> client = dat_file_client->Deserialize();
+    if (!client) {
+      return nullptr;
+    }
+    dat_file_client->idle_clients_.push_back(std::move(client));
+    return dat_file_client;
+  }
+
+ private:
+  friend class base::RefCountedDeleteOnSequence<DATFileClient<T>>;
+  friend class base::DeleteHelper<DATFileClient<T>>;
+
+  explicit DATFileClient(DATFileData data)
+      : base::RefCountedDeleteOnSequence<DATFileClient<T>>(
+            base::SequencedTaskRunnerHandle::Get()),
+        data_(std::move(data)) {}
+  ~DATFileClient() {}
+
+  std::unique_ptr<T> Deserialize() const {
+    std::unique_ptr<T> client(new T());
+    // The clients only read from the buffer, despite the non-const
+    // signature, so the mapping can stay read-only.
+    if (!client->deserialize(const_cast<char*>(
+            reinterpret_cast<const char*>(data_->data())))) {
+      return nullptr;
+    }
+    return client;
+  }
+
+  std::unique_ptr<T> TakeClient() {
+    {
+      base::AutoLock lock(lock_);
+      if (!idle_clients_.empty()) {
+        std::unique_ptr<T> client = std::move(idle_clients_.back());
+        idle_clients_.pop_back();
+        return client;
+      }
+    }
+    // Every client is in use on another thread.
+    return Deserialize();
+  }
+
+  void ReturnClient(std::unique_ptr<T> client) {
+    base::AutoLock lock(lock_);
+    idle_clients_.push_back(std::move(client));
+  }
+
+  const DATFileData data_;
+  // Only held to move clients in and out, never while matching.
+  base::Lock lock_;
+  std::vector<std::unique_ptr<T>> idle_clients_;
+
+  DISALLOW_COPY_AND_ASSIGN(DATFileClient);
+};
+
+// Maps and deserializes |file_path| into a new client, leaving any client
+// currently in use untouched. Blocks, so it must run on a task runner that
+// may block. Returns nullptr on failure.
+template <class T>
+scoped_refptr<DATFileClient<T>> LoadDATFileClient(
+    const base::FilePath& file_path) {
+  DATFileData data;
+  GetDATFileData(file_path, &data);
+  return DATFileClient<T>::Create(std::move(data));
+}
 
 }  // namespace brave_shields
 
@@ -0,0 +1,92 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/dat_file_util.h"
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/scoped_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::DATFileClient;
+using brave_shields::LoadDATFileClient;
+
+namespace {
+
+// Stands in for the vendored clients, which deserialize from a buffer that
+// starts with their format.
+class FakeClient {
+ public:
+  FakeClient() : data_(nullptr) {}
+
+  bool deserialize(char* data) {
+    ++deserialize_count_;
+    data_ = data;
+    return data[0] == 'D';
+  }
+
+  const char* data() const { return data_; }
+
+  static int deserialize_count_;
+
+ private:
+  const char* data_;
+};
+
+int FakeClient::deserialize_count_ = 0;
+
+class DATFileUtilTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    FakeClient::deserialize_count_ = 0;
+  }
+
+  base::FilePath WriteDATFile(const std::string& contents) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII("test.dat");
+    EXPECT_EQ(base::WriteFile(path, contents.data(), contents.size()),
+              static_cast<int>(contents.size()));
+    return path;
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+}  // namespace
+
+TEST_F(DATFileUtilTest, RejectsDataThatDoesNotDeserialize) {
+  EXPECT_FALSE(LoadDATFileClient<FakeClient>(WriteDATFile("XYZ")));
+  EXPECT_FALSE(LoadDATFileClient<FakeClient>(
+      temp_dir_.GetPath().AppendASCII("missing.dat")));
+}
+
+TEST_F(DATFileUtilTest, GivesEachConcurrentUserItsOwnClient) {
+  scoped_refptr<DATFileClient<FakeClient>> dat_file_client =
+      LoadDATFileClient<FakeClient>(WriteDATFile("DAT"));
+  ASSERT_TRUE(dat_file_client);
+  EXPECT_EQ(FakeClient::deserialize_count_, 1);
+
+  {
+    DATFileClient<FakeClient>::ScopedClient first(dat_file_client.get());
+    DATFileClient<FakeClient>::ScopedClient second(dat_file_client.get());
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_NE(first.get(), second.get());
+    // Both point into the same mapping.
+    EXPECT_EQ(first->data(), second->data());
+    EXPECT_EQ(FakeClient::deserialize_count_, 2);
+  }
+
+  // Returned clients are reused.
+  {
+    DATFileClient<FakeClient>::ScopedClient first(dat_file_client.get());
+    DATFileClient<FakeClient>::ScopedClient second(dat_file_client.get());
+    EXPECT_NE(first.get(), second.get());
+  }
+  EXPECT_EQ(FakeClient::deserialize_count_, 2);
+}
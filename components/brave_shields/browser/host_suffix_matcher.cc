@@ -0,0 +1,43 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/host_suffix_matcher.h"
+
+#include <utility>
+
+namespace brave_shields {
+
+HostSuffixMatcher::HostSuffixMatcher(std::vector<std::string> hosts)
+    : storage_(std::move(hosts)) {
+  hosts_.reserve(storage_.size());
+  for (const std::string& host : storage_) {
+    if (!host.empty()) {
+      hosts_.insert(host);
+    }
+  }
+}
+
+HostSuffixMatcher::~HostSuffixMatcher() {
+}
+
+bool HostSuffixMatcher::MatchesExactly(base::StringPiece host) const {
+  return hosts_.find(host) != hosts_.end();
+}
+
+bool HostSuffixMatcher::Matches(base::StringPiece host) const {
+  // Check |host| and then each of its parent domains.
+  while (!host.empty()) {
+    if (MatchesExactly(host)) {
+      return true;
+    }
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos) {
+      break;
+    }
+    host.remove_prefix(dot + 1);
+  }
+  return false;
+}
+
+}  // namespace brave_shields
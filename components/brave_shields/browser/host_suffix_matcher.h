@@ -0,0 +1,41 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HOST_SUFFIX_MATCHER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HOST_SUFFIX_MATCHER_H_
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace brave_shields {
+
+// A set of hosts compiled for lookups by host and by parent domain. Lookups
+// hash each label suffix of the queried host once and never allocate.
+// Immutable after construction, so it can be shared across threads.
+class HostSuffixMatcher {
+ public:
+  explicit HostSuffixMatcher(std::vector<std::string> hosts);
+  ~HostSuffixMatcher();
+
+  // True if |host| is one of the hosts.
+  bool MatchesExactly(base::StringPiece host) const;
+
+  // True if |host| is one of the hosts or a subdomain of one of them.
+  bool Matches(base::StringPiece host) const;
+
+ private:
+  // Owns the strings the pieces in |hosts_| point into.
+  const std::vector<std::string> storage_;
+  std::unordered_set<base::StringPiece, base::StringPieceHash> hosts_;
+
+  DISALLOW_COPY_AND_ASSIGN(HostSuffixMatcher);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HOST_SUFFIX_MATCHER_H_
@@ -0,0 +1,32 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/host_suffix_matcher.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::HostSuffixMatcher;
+
+TEST(HostSuffixMatcherTest, MatchesHostAndSubdomains) {
+  HostSuffixMatcher matcher({"facebook.com", "twimg.com"});
+  EXPECT_TRUE(matcher.Matches("facebook.com"));
+  EXPECT_TRUE(matcher.Matches("connect.facebook.com"));
+  EXPECT_TRUE(matcher.Matches("a.b.twimg.com"));
+  EXPECT_FALSE(matcher.Matches("notfacebook.com"));
+  EXPECT_FALSE(matcher.Matches("facebook.com.evil.net"));
+  EXPECT_FALSE(matcher.Matches("com"));
+  EXPECT_FALSE(matcher.Matches(""));
+}
+
+TEST(HostSuffixMatcherTest, MatchesExactly) {
+  HostSuffixMatcher matcher({"www.facebook.com"});
+  EXPECT_TRUE(matcher.MatchesExactly("www.facebook.com"));
+  EXPECT_FALSE(matcher.MatchesExactly("facebook.com"));
+  EXPECT_FALSE(matcher.MatchesExactly("sub.www.facebook.com"));
+}
+
+TEST(HostSuffixMatcherTest, IgnoresEmptyHosts) {
+  HostSuffixMatcher matcher({""});
+  EXPECT_FALSE(matcher.Matches(""));
+  EXPECT_FALSE(matcher.Matches("example.com"));
+}
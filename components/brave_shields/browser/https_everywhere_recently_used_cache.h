@@ -2,56 +2,91 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
-#include <unordered_map>
-#include <string>
-#include <vector>
-
-template <class T> class RingBuffer
-{
-private:
-    int currentIdx = 0;
-    int count;
-    std::vector<T> data;
-public:
-    RingBuffer(int fixedSize) : count(fixedSize), data(count) {}
-
-    const T& at(int i) {
-        return data[(currentIdx - (i % count) + count) % count];
-    }
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RECENTLY_USED_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RECENTLY_USED_CACHE_H_
 
-    void add(const T& newValue) {
-        currentIdx = (currentIdx + 1) % count;
-        data[currentIdx] = newValue;
-    }
+#include <stddef.h>
+#include <stdint.h>
 
-    T oldest() {
-        return data[(currentIdx + 1) % count];
-    }
+#include <string>
 
-    void clear() {
-        data = std::vector<T>(count);
-    }
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/metrics/histogram_macros_local.h"
+#include "base/synchronization/lock.h"
+
+// Outcome of a cache lookup or insertion, recorded in the
+// "Brave.HTTPSE.RecentlyUsedCache" local histogram.
+enum class HTTPSECacheEvent {
+  kHit = 0,
+  kNegativeHit = 1,
+  kMiss = 2,
+  kEviction = 3,
+  kMaxValue = kEviction,
 };
 
-template <class T> class HTTPSERecentlyUsedCache
-{
-private:
-    RingBuffer<T> keysByAge;
-public:
-    std::unordered_map<std::string, T> data;
-
-    HTTPSERecentlyUsedCache(unsigned int size = 100) : keysByAge(size) {}
-
-    void add(const std::string& key, const T& value) {
-        std::string old = keysByAge.oldest();
-        if (!old.empty()) {
-            keysByAge.data.erase(old);
-        }
-        keysByAge[key] = value;
+// Bounded LRU of URL lookup results. A value equal to T() is a negative
+// entry, i.e. a URL known to have no rewrite. Lookups and insertions are
+// O(1) and may happen on different threads.
+template <class T> class HTTPSERecentlyUsedCache {
+ public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t negative_hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+  };
+
+  explicit HTTPSERecentlyUsedCache(size_t capacity = 100)
+      : data_(capacity) {}
+
+  // Returns false if |key| is not cached. A negative hit returns true and
+  // sets |value| to T().
+  bool Get(const std::string& key, T* value) {
+    base::AutoLock lock(lock_);
+    auto it = data_.Get(key);
+    if (it == data_.end()) {
+      Record(HTTPSECacheEvent::kMiss, &stats_.misses);
+      return false;
+    }
+    *value = it->second;
+    if (*value == T()) {
+      Record(HTTPSECacheEvent::kNegativeHit, &stats_.negative_hits);
+    } else {
+      Record(HTTPSECacheEvent::kHit, &stats_.hits);
     }
+    return true;
+  }
 
-    void clear() {
-        data.clear();
-        keysByAge.clear();
+  void Add(const std::string& key, const T& value) {
+    base::AutoLock lock(lock_);
+    if (data_.Peek(key) == data_.end() && data_.size() >= data_.max_size()) {
+      Record(HTTPSECacheEvent::kEviction, &stats_.evictions);
     }
+    data_.Put(key, value);
+  }
+
+  void Clear() {
+    base::AutoLock lock(lock_);
+    data_.Clear();
+  }
+
+  Stats GetStats() const {
+    base::AutoLock lock(lock_);
+    return stats_;
+  }
+
+ private:
+  void Record(HTTPSECacheEvent event, uint64_t* counter) {
+    ++*counter;
+    LOCAL_HISTOGRAM_ENUMERATION("Brave.HTTPSE.RecentlyUsedCache", event);
+  }
+
+  mutable base::Lock lock_;
+  base::HashingMRUCache<std::string, T> data_;
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSERecentlyUsedCache);
 };
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RECENTLY_USED_CACHE_H_
@@ -0,0 +1,44 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(HTTPSERecentlyUsedCacheTest, EvictsLeastRecentlyUsed) {
+  HTTPSERecentlyUsedCache<std::string> cache(2);
+  std::string value;
+  cache.Add("http://a.com/", "https://a.com/");
+  cache.Add("http://b.com/", "https://b.com/");
+  // Touch a.com so that b.com is the oldest entry.
+  EXPECT_TRUE(cache.Get("http://a.com/", &value));
+  EXPECT_EQ("https://a.com/", value);
+  cache.Add("http://c.com/", "https://c.com/");
+
+  EXPECT_FALSE(cache.Get("http://b.com/", &value));
+  EXPECT_TRUE(cache.Get("http://a.com/", &value));
+  EXPECT_TRUE(cache.Get("http://c.com/", &value));
+
+  HTTPSERecentlyUsedCache<std::string>::Stats stats = cache.GetStats();
+  EXPECT_EQ(3u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(1u, stats.evictions);
+}
+
+TEST(HTTPSERecentlyUsedCacheTest, NegativeEntries) {
+  HTTPSERecentlyUsedCache<std::string> cache(2);
+  std::string value = "stale";
+  cache.Add("http://a.com/", "");
+  EXPECT_TRUE(cache.Get("http://a.com/", &value));
+  EXPECT_TRUE(value.empty());
+  // Replacing an existing entry is not an eviction.
+  cache.Add("http://a.com/", "https://a.com/");
+
+  HTTPSERecentlyUsedCache<std::string>::Stats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.negative_hits);
+  EXPECT_EQ(0u, stats.hits);
+  EXPECT_EQ(0u, stats.evictions);
+
+  cache.Clear();
+  EXPECT_FALSE(cache.Get("http://a.com/", &value));
+}
@@ -0,0 +1,153 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/values.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace brave_shields {
+
+HTTPSERuleSet::Pattern::Pattern(const std::string& pattern)
+    : source(pattern) {
+}
+
+HTTPSERuleSet::Pattern::~Pattern() {
+}
+
+const re2::RE2& HTTPSERuleSet::Pattern::Get() const {
+  if (!compiled)
+    compiled.reset(new re2::RE2(source));
+  return *compiled;
+}
+
+HTTPSERuleSet::Rule::Rule() : is_default(false) {
+}
+
+HTTPSERuleSet::Rule::Rule(Rule&& other) = default;
+
+HTTPSERuleSet::Rule::~Rule() {
+}
+
+HTTPSERuleSet::Target::Target() : has_rules(false) {
+}
+
+HTTPSERuleSet::Target::Target(Target&& other) = default;
+
+HTTPSERuleSet::Target::~Target() {
+}
+
+HTTPSERuleSet::HTTPSERuleSet() {
+}
+
+HTTPSERuleSet::~HTTPSERuleSet() {
+}
+
+// static
+std::unique_ptr<HTTPSERuleSet> HTTPSERuleSet::Parse(base::StringPiece json) {
+  std::unique_ptr<base::Value> json_object = base::JSONReader::Read(json);
+  if (!json_object || !json_object->is_list()) {
+    return nullptr;
+  }
+
+  std::unique_ptr<HTTPSERuleSet> rule_set(new HTTPSERuleSet());
+  for (const base::Value& child_top_value : json_object->GetList()) {
+    if (!child_top_value.is_dict()) {
+      continue;
+    }
+
+    Target target;
+    const base::Value* exclusions =
+        child_top_value.FindKeyOfType("e", base::Value::Type::LIST);
+    if (exclusions) {
+      for (const base::Value& exclusion : exclusions->GetList()) {
+        if (!exclusion.is_dict()) {
+          continue;
+        }
+        const base::Value* pattern =
+            exclusion.FindKeyOfType("p", base::Value::Type::STRING);
+        if (!pattern) {
+          continue;
+        }
+        target.exclusions.push_back(std::make_unique<Pattern>(
+            CorrectToRuleToRE2Engine(pattern->GetString())));
+      }
+    }
+
+    const base::Value* rules =
+        child_top_value.FindKeyOfType("r", base::Value::Type::LIST);
+    if (rules) {
+      target.has_rules = true;
+      for (const base::Value& rule_value : rules->GetList()) {
+        if (!rule_value.is_dict()) {
+          continue;
+        }
+        Rule rule;
+        if (rule_value.FindKey("d")) {
+          rule.is_default = true;
+          target.rules.push_back(std::move(rule));
+          continue;
+        }
+        const base::Value* from =
+            rule_value.FindKeyOfType("f", base::Value::Type::STRING);
+        const base::Value* to =
+            rule_value.FindKeyOfType("t", base::Value::Type::STRING);
+        if (!from || !to) {
+          continue;
+        }
+        rule.from = std::make_unique<Pattern>(from->GetString());
+        rule.to = CorrectToRuleToRE2Engine(to->GetString());
+        target.rules.push_back(std::move(rule));
+      }
+    }
+    rule_set->targets_.push_back(std::move(target));
+  }
+
+  return rule_set;
+}
+
+std::string HTTPSERuleSet::Apply(const std::string& original_url) const {
+  for (const Target& target : targets_) {
+    for (const auto& exclusion : target.exclusions) {
+      if (re2::RE2::FullMatch(original_url, exclusion->Get())) {
+        return "";
+      }
+    }
+
+    if (!target.has_rules) {
+      return "";
+    }
+
+    for (const Rule& rule : target.rules) {
+      if (rule.is_default) {
+        std::string new_url(original_url);
+        return new_url.insert(4, "s");
+      }
+
+      std::string new_url(original_url);
+      if (re2::RE2::Replace(&new_url, rule.from->Get(), rule.to) &&
+          new_url != original_url) {
+        return new_url;
+      }
+    }
+  }
+  return "";
+}
+
+// static
+std::string HTTPSERuleSet::CorrectToRuleToRE2Engine(const std::string& to) {
+  std::string corrected_to(to);
+  size_t pos = corrected_to.find("$");
+  while (std::string::npos != pos) {
+    corrected_to[pos] = '\\';
+    pos = corrected_to.find("$", pos + 1);
+  }
+
+  return corrected_to;
+}
+
+}  // namespace brave_shields
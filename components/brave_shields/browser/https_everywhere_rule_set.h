@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_SET_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_SET_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace re2 {
+class RE2;
+}
+
+namespace brave_shields {
+
+// Compiled form of one HTTPS Everywhere database value. The JSON value is
+// parsed once, and each RE2 program is built the first time it is needed and
+// then kept for the lifetime of the rule set. Not thread safe: a rule set
+// must only be used on the sequence that owns it.
+class HTTPSERuleSet {
+ public:
+  ~HTTPSERuleSet();
+
+  // Returns nullptr if |json| is not a valid rule set.
+  static std::unique_ptr<HTTPSERuleSet> Parse(base::StringPiece json);
+
+  // Returns the rewritten URL, or an empty string if no rule applies.
+  std::string Apply(const std::string& original_url) const;
+
+  // Converts $1-style back references to the \1 form used by RE2.
+  static std::string CorrectToRuleToRE2Engine(const std::string& to);
+
+ private:
+  struct Pattern {
+    explicit Pattern(const std::string& pattern);
+    ~Pattern();
+    const re2::RE2& Get() const;
+
+    std::string source;
+    mutable std::unique_ptr<re2::RE2> compiled;
+  };
+
+  struct Rule {
+    Rule();
+    Rule(Rule&& other);
+    ~Rule();
+
+    bool is_default;
+    std::unique_ptr<Pattern> from;
+    std::string to;
+  };
+
+  struct Target {
+    Target();
+    Target(Target&& other);
+    ~Target();
+
+    std::vector<std::unique_ptr<Pattern>> exclusions;
+    // False when the entry has no usable "r" list, which stops the lookup.
+    bool has_rules;
+    std::vector<Rule> rules;
+  };
+
+  HTTPSERuleSet();
+
+  std::vector<Target> targets_;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSERuleSet);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_SET_H_
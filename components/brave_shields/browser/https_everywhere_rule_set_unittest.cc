@@ -0,0 +1,47 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::HTTPSERuleSet;
+
+TEST(HTTPSERuleSetTest, InvalidJson) {
+  EXPECT_EQ(nullptr, HTTPSERuleSet::Parse(""));
+  EXPECT_EQ(nullptr, HTTPSERuleSet::Parse("{\"r\": []}"));
+}
+
+TEST(HTTPSERuleSetTest, FromToRule) {
+  std::unique_ptr<HTTPSERuleSet> rule_set = HTTPSERuleSet::Parse(
+      "[{\"r\": [{\"f\": \"^http://(www\\\\.)?example\\\\.com/\","
+      "\"t\": \"https://$1example.com/\"}]}]");
+  ASSERT_NE(nullptr, rule_set);
+  EXPECT_EQ("https://www.example.com/a",
+            rule_set->Apply("http://www.example.com/a"));
+  // Applying a second time reuses the compiled program.
+  EXPECT_EQ("https://example.com/b", rule_set->Apply("http://example.com/b"));
+  EXPECT_EQ("", rule_set->Apply("http://other.com/"));
+}
+
+TEST(HTTPSERuleSetTest, DefaultRule) {
+  std::unique_ptr<HTTPSERuleSet> rule_set =
+      HTTPSERuleSet::Parse("[{\"r\": [{\"d\": 1}]}]");
+  ASSERT_NE(nullptr, rule_set);
+  EXPECT_EQ("https://example.com/", rule_set->Apply("http://example.com/"));
+}
+
+TEST(HTTPSERuleSetTest, Exclusion) {
+  std::unique_ptr<HTTPSERuleSet> rule_set = HTTPSERuleSet::Parse(
+      "[{\"e\": [{\"p\": \"^http://example\\\\.com/insecure.*\"}],"
+      "\"r\": [{\"d\": 1}]}]");
+  ASSERT_NE(nullptr, rule_set);
+  EXPECT_EQ("", rule_set->Apply("http://example.com/insecure/page"));
+  EXPECT_EQ("https://example.com/secure",
+            rule_set->Apply("http://example.com/secure"));
+}
+
+TEST(HTTPSERuleSetTest, CorrectToRuleToRE2Engine) {
+  EXPECT_EQ("https://\\1a\\2/",
+            HTTPSERuleSet::CorrectToRuleToRE2Engine("https://$1a$2/"));
+}
@@ -10,23 +10,22 @@
 #include <vector>
 
 #include "base/base_paths.h"
-#include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
-#include "base/values.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
 #include "chrome/browser/browser_process.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
-#include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
 #define DAT_FILE "httpse.leveldb.zip"
 #define DAT_FILE_VERSION "6.0"
-#define HTTPSE_URLS_REDIRECTS_COUNT_QUEUE   1
+#define TRIE_FILE "httpse.trie"
 #define HTTPSE_URL_MAX_REDIRECTS_COUNT      5
+#define HTTPSE_RULE_SET_CACHE_SIZE          1000
+#define HTTPSE_RECENTLY_USED_CACHE_SIZE     1000
 
 namespace {
   std::vector<std::string> Split(const std::string& s, char delim) {
@@ -82,7 +81,11 @@ std::string HTTPSEverywhereService::g_https_everywhere_component_id_(
 std::string HTTPSEverywhereService::g_https_everywhere_component_base64_public_key_(
     kHTTPSEverywhereComponentBase64PublicKey);
 
-HTTPSEverywhereService::HTTPSEverywhereService() : level_db_(nullptr) {
+HTTPSEverywhereService::HTTPSEverywhereService()
+    : recently_used_cache_(HTTPSE_RECENTLY_USED_CACHE_SIZE),
+      rule_set_cache_(HTTPSE_RULE_SET_CACHE_SIZE),
+      trie_rule_set_cache_(HTTPSE_RULE_SET_CACHE_SIZE),
+      level_db_(nullptr) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
@@ -109,14 +112,24 @@ void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
       install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(DAT_FILE);
   base::FilePath unzipped_level_db_path = zip_db_file_path.RemoveExtension();
   base::FilePath destination = zip_db_file_path.DirName();
+  base::FilePath trie_file_path = destination.AppendASCII(TRIE_FILE);
+
+  CloseDatabase();
+  recently_used_cache_.Clear();
+
+  // The trie is generated from the LevelDB database the first time a
+  // component version is installed.
+  trie_ = HTTPSETrie::Open(trie_file_path);
+  if (trie_) {
+    return;
+  }
+
   if (!zip::Unzip(zip_db_file_path, destination)) {
     LOG(ERROR) << "Failed to unzip database file "
                << zip_db_file_path.value().c_str();
     return;
   }
 
-  CloseDatabase();
-
   leveldb::Options options;
   leveldb::Status status =
       leveldb::DB::Open(options,
@@ -130,6 +143,18 @@ void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
     CloseDatabase();
     return;
   }
+
+  if (HTTPSETrieBuilder::ConvertLevelDB(level_db_, trie_file_path)) {
+    trie_ = HTTPSETrie::Open(trie_file_path);
+  }
+  if (trie_) {
+    delete level_db_;
+    level_db_ = nullptr;
+  } else {
+    LOG(ERROR) << "Failed to convert database to "
+               << trie_file_path.value().c_str()
+               << ", falling back to LevelDB";
+  }
 }
 
 void HTTPSEverywhereService::OnComponentReady(
@@ -144,21 +169,18 @@ void HTTPSEverywhereService::OnComponentReady(
 }
 
 bool HTTPSEverywhereService::GetHTTPSURL(
-    const GURL* url, const uint64_t& request_identifier,
+    const GURL* url, int redirects_count,
     std::string& new_url) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  base::ScopedBlockingCall scoped_blocking_call(
-      base::BlockingType::WILL_BLOCK);
-  if (!IsInitialized() || !level_db_ || url->scheme() == url::kHttpsScheme) {
+  if (!IsInitialized() || (!trie_ && !level_db_) ||
+      url->scheme() == url::kHttpsScheme) {
     return false;
   }
-  if (!ShouldHTTPSERedirect(request_identifier)) {
+  if (!ShouldHTTPSERedirect(redirects_count)) {
     return false;
   }
 
-  if (recently_used_cache_.data.count(url->spec()) > 0) {
-    AddHTTPSEUrlToRedirectList(request_identifier);
-    new_url = recently_used_cache_.data[url->spec()];
+  if (recently_used_cache_.Get(url->spec(), &new_url)) {
     return true;
   }
 
@@ -169,203 +191,113 @@ bool HTTPSEverywhereService::GetHTTPSURL(
     candidate_url = candidate_url.ReplaceComponents(replacements);
   }
 
-  const std::vector<std::string> domains = ExpandDomainForLookup(candidate_url.host());
+  bool found = trie_ ? GetHTTPSURLFromTrie(candidate_url, &new_url) :
+      GetHTTPSURLFromLevelDB(candidate_url, &new_url);
+  if (found) {
+    recently_used_cache_.Add(candidate_url.spec(), new_url);
+    return true;
+  }
+  new_url.clear();
+  recently_used_cache_.Add(candidate_url.spec(), new_url);
+  return false;
+}
+
+bool HTTPSEverywhereService::GetHTTPSURLFromTrie(const GURL& candidate_url,
+                                                 std::string* new_url) {
+  HTTPSETrie::Matches matches;
+  trie_->Find(candidate_url.host_piece(), &matches);
+  for (size_t i = 0; i < matches.count; ++i) {
+    const HTTPSERuleSet* rule_set = GetRuleSetFromTrie(matches.ids[i]);
+    if (rule_set) {
+      *new_url = rule_set->Apply(candidate_url.spec());
+      if (0 != new_url->length()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool HTTPSEverywhereService::GetHTTPSURLFromLevelDB(const GURL& candidate_url,
+                                                    std::string* new_url) {
+  base::ScopedBlockingCall scoped_blocking_call(
+      base::BlockingType::WILL_BLOCK);
+  const std::vector<std::string> domains =
+      ExpandDomainForLookup(candidate_url.host());
   for (auto domain : domains) {
-    std::string value = leveldbGet(level_db_, domain);
-    if (!value.empty()) {
-      new_url = ApplyHTTPSRule(candidate_url.spec(), value);
-      if (0 != new_url.length()) {
-        recently_used_cache_.data[candidate_url.spec()] = new_url;
-        AddHTTPSEUrlToRedirectList(request_identifier);
+    const HTTPSERuleSet* rule_set = GetRuleSet(domain);
+    if (rule_set) {
+      *new_url = rule_set->Apply(candidate_url.spec());
+      if (0 != new_url->length()) {
         return true;
       }
     }
   }
-  recently_used_cache_.data[candidate_url.spec()].clear();
   return false;
 }
 
 bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
     const GURL* url,
-    const uint64_t& request_identifier,
+    int redirects_count,
     std::string& cached_url) {
   if (!IsInitialized() || url->scheme() == url::kHttpsScheme) {
     return false;
   }
-  if (!ShouldHTTPSERedirect(request_identifier)) {
+  if (!ShouldHTTPSERedirect(redirects_count)) {
     return false;
   }
 
-  if (recently_used_cache_.data.count(url->spec()) > 0) {
-    AddHTTPSEUrlToRedirectList(request_identifier);
-    cached_url = recently_used_cache_.data[url->spec()];
+  if (recently_used_cache_.Get(url->spec(), &cached_url)) {
     return true;
   }
   return false;
 }
 
-bool HTTPSEverywhereService::ShouldHTTPSERedirect(
-    const uint64_t& request_identifier) {
-  std::lock_guard<std::mutex> guard(httpse_get_urls_redirects_count_mutex_);
-  for (size_t i = 0; i < httpse_urls_redirects_count_.size(); i++) {
-    if (request_identifier ==
-        httpse_urls_redirects_count_[i].request_identifier_ &&
-        httpse_urls_redirects_count_[i].redirects_ >=
-        HTTPSE_URL_MAX_REDIRECTS_COUNT - 1) {
-      return false;
-    }
-  }
-
-  return true;
+HTTPSERecentlyUsedCache<std::string>::Stats
+HTTPSEverywhereService::GetRecentlyUsedCacheStats() const {
+  return recently_used_cache_.GetStats();
 }
 
-void HTTPSEverywhereService::AddHTTPSEUrlToRedirectList(
-    const uint64_t& request_identifier) {
-  // Adding redirects count for the current request
-  std::lock_guard<std::mutex> guard(httpse_get_urls_redirects_count_mutex_);
-  bool hostFound = false;
-  for (size_t i = 0; i < httpse_urls_redirects_count_.size(); i++) {
-    if (request_identifier ==
-        httpse_urls_redirects_count_[i].request_identifier_) {
-      // Found the host, just increment the redirects_count
-      httpse_urls_redirects_count_[i].redirects_++;
-      hostFound = true;
-      break;
-    }
-  }
-  if (!hostFound) {
-      // The host is new, adding it to the redirects list
-      if (httpse_urls_redirects_count_.size() >=
-          HTTPSE_URLS_REDIRECTS_COUNT_QUEUE) {
-          // The queue is full, erase the first element
-          httpse_urls_redirects_count_.erase(
-              httpse_urls_redirects_count_.begin());
-      }
-      httpse_urls_redirects_count_.push_back(
-          HTTPSE_REDIRECTS_COUNT_ST(request_identifier, 1));
-  }
+// static
+bool HTTPSEverywhereService::ShouldHTTPSERedirect(int redirects_count) {
+  return redirects_count < HTTPSE_URL_MAX_REDIRECTS_COUNT - 1;
 }
 
-std::string HTTPSEverywhereService::ApplyHTTPSRule(
-    const std::string& originalUrl,
-    const std::string& rule) {
-  std::unique_ptr<base::Value> json_object = base::JSONReader::Read(rule);
-  if (nullptr == json_object.get()) {
-    return "";
+const HTTPSERuleSet* HTTPSEverywhereService::GetRuleSet(
+    const std::string& lookup_key) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = rule_set_cache_.Get(lookup_key);
+  if (it != rule_set_cache_.end()) {
+    return it->second.get();
   }
 
-  const base::ListValue* topValues = nullptr;
-  json_object->GetAsList(&topValues);
-  if (nullptr == topValues) {
-    return "";
+  std::unique_ptr<HTTPSERuleSet> rule_set;
+  std::string value = leveldbGet(level_db_, lookup_key);
+  if (!value.empty()) {
+    rule_set = HTTPSERuleSet::Parse(value);
   }
-
-  for (size_t i = 0; i < topValues->GetSize(); ++i) {
-    const base::Value* childTopValue = nullptr;
-    if (!topValues->Get(i, &childTopValue)) {
-      continue;
-    }
-    const base::DictionaryValue* childTopDictionary = nullptr;
-    childTopValue->GetAsDictionary(&childTopDictionary);
-    if (nullptr == childTopDictionary) {
-      continue;
-    }
-
-    const base::Value* exclusion = nullptr;
-    if (childTopDictionary->Get("e", &exclusion)) {
-      const base::ListValue* eValues = nullptr;
-      exclusion->GetAsList(&eValues);
-      if (nullptr != eValues) {
-        for (size_t j = 0; j < eValues->GetSize(); ++j) {
-          const base::Value* pValue = nullptr;
-          if (!eValues->Get(j, &pValue)) {
-            continue;
-          }
-          const base::DictionaryValue* pDictionary = nullptr;
-          pValue->GetAsDictionary(&pDictionary);
-          if (nullptr == pDictionary) {
-            continue;
-          }
-          const base::Value* patternValue = nullptr;
-          if (!pDictionary->Get("p", &patternValue)) {
-            continue;
-          }
-          std::string pattern;
-          if (!patternValue->GetAsString(&pattern)) {
-            continue;
-          }
-          pattern = CorrecttoRuleToRE2Engine(pattern);
-          if (RE2::FullMatch(originalUrl, pattern)) {
-            return "";
-          }
-        }
-      }
-    }
-
-    const base::Value* rules = nullptr;
-    if (!childTopDictionary->Get("r", &rules)) {
-      return "";
-    }
-    const base::ListValue* rValues = nullptr;
-    rules->GetAsList(&rValues);
-    if (nullptr == rValues) {
-      return "";
-    }
-
-    for (size_t j = 0; j < rValues->GetSize(); ++j) {
-      const base::Value* pValue = nullptr;
-      if (!rValues->Get(j, &pValue)) {
-        continue;
-      }
-      const base::DictionaryValue* pDictionary = nullptr;
-      pValue->GetAsDictionary(&pDictionary);
-      if (nullptr == pDictionary) {
-        continue;
-      }
-      const base::Value* patternValue = nullptr;
-      if (pDictionary->Get("d", &patternValue)) {
-        std::string newUrl(originalUrl);
-        return newUrl.insert(4, "s");
-      }
-
-      const base::Value* from_value = nullptr;
-      const base::Value* to_value = nullptr;
-      if (!pDictionary->Get("f", &from_value) ||
-          !pDictionary->Get("t", &to_value)) {
-        continue;
-      }
-      std::string from, to;
-      if (!from_value->GetAsString(&from) ||
-          !to_value->GetAsString(&to)) {
-        continue;
-      }
-
-      to = CorrecttoRuleToRE2Engine(to);
-      std::string newUrl(originalUrl);
-      RE2 regExp(from);
-
-      if (RE2::Replace(&newUrl, regExp, to) && newUrl != originalUrl) {
-        return newUrl;
-      }
-    }
-  }
-  return "";
+  return rule_set_cache_.Put(lookup_key, std::move(rule_set))->second.get();
 }
 
-std::string HTTPSEverywhereService::CorrecttoRuleToRE2Engine(
-    const std::string& to) {
-  std::string correctedto(to);
-  size_t pos = to.find("$");
-  while (std::string::npos != pos) {
-    correctedto[pos] = '\\';
-    pos = correctedto.find("$");
+const HTTPSERuleSet* HTTPSEverywhereService::GetRuleSetFromTrie(
+    uint32_t rule_set_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = trie_rule_set_cache_.Get(rule_set_id);
+  if (it != trie_rule_set_cache_.end()) {
+    return it->second.get();
   }
 
-  return correctedto;
+  std::unique_ptr<HTTPSERuleSet> rule_set =
+      HTTPSERuleSet::Parse(trie_->GetRuleSet(rule_set_id));
+  return trie_rule_set_cache_.Put(rule_set_id, std::move(rule_set))
+      ->second.get();
 }
 
 void HTTPSEverywhereService::CloseDatabase() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  rule_set_cache_.Clear();
+  trie_rule_set_cache_.Clear();
+  trie_.reset();
   if (level_db_) {
     delete level_db_;
     level_db_ = nullptr;
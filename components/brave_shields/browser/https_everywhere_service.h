@@ -10,12 +10,14 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <mutex>
 
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/sequence_checker.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+#include "brave/components/brave_shields/browser/https_everywhere_trie.h"
 #include "content/public/common/resource_type.h"
 
 namespace leveldb {
@@ -38,26 +40,18 @@ const std::string kHTTPSEverywhereComponentBase64PublicKey =
     "OtZqgfRg8Da4i+NwmjQqrz0JFtPMMSyUnmeMj+mSOL4xZVWr8fU2/GOCXs9gczDp"
     "JwIDAQAB";
 
-struct HTTPSE_REDIRECTS_COUNT_ST {
-public:
-    HTTPSE_REDIRECTS_COUNT_ST(uint64_t request_identifier,
-        unsigned int redirects):
-      request_identifier_(request_identifier),
-      redirects_(redirects) {
-    }
-
-    uint64_t request_identifier_;
-    unsigned int redirects_;
-};
-
 class HTTPSEverywhereService : public BaseBraveShieldsService {
  public:
    HTTPSEverywhereService();
    ~HTTPSEverywhereService() override;
-  bool GetHTTPSURL(const GURL* url, const uint64_t& request_id,
+  // |redirects_count| is the number of upgrades already applied to the
+  // request, used to break redirect loops.
+  bool GetHTTPSURL(const GURL* url, int redirects_count,
       std::string& new_url);
   bool GetHTTPSURLFromCacheOnly(const GURL* url,
-      const uint64_t& request_id, std::string& cached_url);
+      int redirects_count, std::string& cached_url);
+  HTTPSERecentlyUsedCache<std::string>::Stats GetRecentlyUsedCacheStats()
+      const;
 
  protected:
   bool Init() override;
@@ -66,11 +60,9 @@ class HTTPSEverywhereService : public BaseBraveShieldsService {
       const base::FilePath& install_dir,
       const std::string& manifest) override;
 
-  void AddHTTPSEUrlToRedirectList(const uint64_t& request_id);
-  bool ShouldHTTPSERedirect(const uint64_t& request_id);
-  std::string ApplyHTTPSRule(const std::string& originalUrl,
-      const std::string& rule);
-  std::string CorrecttoRuleToRE2Engine(const std::string& to);
+  static bool ShouldHTTPSERedirect(int redirects_count);
+  const HTTPSERuleSet* GetRuleSet(const std::string& lookup_key);
+  const HTTPSERuleSet* GetRuleSetFromTrie(uint32_t rule_set_id);
 
  private:
   friend class ::HTTPSEverywhereServiceTest;
@@ -85,10 +77,20 @@ class HTTPSEverywhereService : public BaseBraveShieldsService {
   void CloseDatabase();
 
   void InitDB(const base::FilePath& install_dir);
+  bool GetHTTPSURLFromTrie(const GURL& candidate_url, std::string* new_url);
+  bool GetHTTPSURLFromLevelDB(const GURL& candidate_url,
+                              std::string* new_url);
 
-  std::mutex httpse_get_urls_redirects_count_mutex_;
-  std::vector<HTTPSE_REDIRECTS_COUNT_ST> httpse_urls_redirects_count_;
   HTTPSERecentlyUsedCache<std::string> recently_used_cache_;
+  // Compiled rule sets keyed by database lookup key. A null entry records
+  // that the key has no rule set, so it is not looked up again.
+  base::HashingMRUCache<std::string, std::unique_ptr<HTTPSERuleSet>>
+      rule_set_cache_;
+  // Same as |rule_set_cache_|, keyed by HTTPSETrie rule set id.
+  base::HashingMRUCache<uint32_t, std::unique_ptr<HTTPSERuleSet>>
+      trie_rule_set_cache_;
+  // When the trie is available the LevelDB database is not kept open.
+  std::unique_ptr<HTTPSETrie> trie_;
   leveldb::DB* level_db_;
 
   SEQUENCE_CHECKER(sequence_checker_);
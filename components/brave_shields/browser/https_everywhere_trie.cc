@@ -0,0 +1,322 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_trie.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/containers/queue.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/logging.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "third_party/leveldatabase/src/include/leveldb/db.h"
+
+namespace brave_shields {
+
+namespace {
+
+const char kMagic[4] = {'H', 'S', 'E', 'T'};
+const uint32_t kVersion = 1;
+const uint32_t kNoRuleSet = 0xFFFFFFFF;
+const char kWildcardSuffix[] = ".*";
+
+}  // namespace
+
+// File layout: Header, |node_count| Nodes in breadth first order (so the
+// children of a node are contiguous and sorted by label), the label bytes,
+// then the rule sets, each prefixed with its uint32_t length. A rule set id
+// is the offset of its length prefix.
+struct HTTPSETrie::Header {
+  char magic[4];
+  uint32_t version;
+  uint32_t node_count;
+  uint32_t labels_size;
+  uint32_t rule_sets_size;
+};
+
+struct HTTPSETrie::Node {
+  uint32_t first_child;
+  uint32_t child_count;
+  uint32_t label_offset;
+  uint32_t label_length;
+  uint32_t exact;
+  uint32_t wildcard;
+};
+
+HTTPSETrie::HTTPSETrie()
+    : header_(nullptr),
+      nodes_(nullptr),
+      labels_(nullptr),
+      rule_sets_(nullptr) {
+}
+
+HTTPSETrie::~HTTPSETrie() {
+}
+
+// static
+std::unique_ptr<HTTPSETrie> HTTPSETrie::Open(const base::FilePath& path) {
+  if (!base::PathExists(path)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<HTTPSETrie> trie(new HTTPSETrie());
+  if (!trie->file_.Initialize(path)) {
+    LOG(ERROR) << "HTTPSETrie: cannot map " << path.value().c_str();
+    return nullptr;
+  }
+  if (!trie->Validate()) {
+    LOG(ERROR) << "HTTPSETrie: corrupted file " << path.value().c_str();
+    return nullptr;
+  }
+  return trie;
+}
+
+bool HTTPSETrie::Validate() {
+  const uint64_t size = file_.length();
+  if (size < sizeof(Header)) {
+    return false;
+  }
+  header_ = reinterpret_cast<const Header*>(file_.data());
+  if (memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header_->version != kVersion ||
+      header_->node_count == 0) {
+    return false;
+  }
+  const uint64_t nodes_size =
+      static_cast<uint64_t>(header_->node_count) * sizeof(Node);
+  if (size != sizeof(Header) + nodes_size + header_->labels_size +
+      header_->rule_sets_size) {
+    return false;
+  }
+  nodes_ = reinterpret_cast<const Node*>(file_.data() + sizeof(Header));
+  labels_ = reinterpret_cast<const char*>(file_.data() + sizeof(Header) +
+                                          nodes_size);
+  rule_sets_ = file_.data() + sizeof(Header) + nodes_size +
+      header_->labels_size;
+
+  // Check every node once here so that lookups need no bounds checks.
+  for (uint32_t i = 0; i < header_->node_count; ++i) {
+    const Node& node = nodes_[i];
+    if (node.child_count > 0 &&
+        (node.first_child <= i ||
+         static_cast<uint64_t>(node.first_child) + node.child_count >
+             header_->node_count)) {
+      return false;
+    }
+    if (static_cast<uint64_t>(node.label_offset) + node.label_length >
+        header_->labels_size) {
+      return false;
+    }
+    for (uint32_t id : {node.exact, node.wildcard}) {
+      if (id != kNoRuleSet && GetRuleSet(id).empty()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+base::StringPiece HTTPSETrie::GetLabel(const Node* node) const {
+  return base::StringPiece(labels_ + node->label_offset, node->label_length);
+}
+
+const HTTPSETrie::Node* HTTPSETrie::GetChild(const Node* node,
+                                             base::StringPiece label) const {
+  const Node* first = nodes_ + node->first_child;
+  const Node* last = first + node->child_count;
+  const Node* it = std::lower_bound(first, last, label,
+      [this](const Node& child, base::StringPiece value) {
+        return GetLabel(&child) < value;
+      });
+  if (it == last || GetLabel(it) != label) {
+    return nullptr;
+  }
+  return it;
+}
+
+void HTTPSETrie::Find(base::StringPiece host, Matches* matches) const {
+  matches->count = 0;
+  if (!host.empty() && host[host.size() - 1] == '.') {
+    host.remove_suffix(1);
+  }
+
+  // path[i] is the node for the last i + 1 labels of |host|.
+  const Node* path[kMaxLabels];
+  size_t depth = 0;
+  size_t label_count = 0;
+  const Node* node = nodes_;
+  size_t end = host.size();
+  while (true) {
+    size_t start = end;
+    while (start > 0 && host[start - 1] != '.') {
+      --start;
+    }
+    ++label_count;
+    if (node && depth < kMaxLabels) {
+      node = GetChild(node, host.substr(start, end - start));
+      if (node) {
+        path[depth++] = node;
+      }
+    }
+    if (start == 0) {
+      break;
+    }
+    end = start - 1;
+  }
+
+  if (label_count < 2) {
+    return;
+  }
+  if (depth == label_count && path[depth - 1]->exact != kNoRuleSet) {
+    matches->ids[matches->count++] = path[depth - 1]->exact;
+  }
+  for (size_t i = std::min(depth, label_count - 1); i >= 2; --i) {
+    if (path[i - 1]->wildcard != kNoRuleSet) {
+      matches->ids[matches->count++] = path[i - 1]->wildcard;
+    }
+  }
+}
+
+base::StringPiece HTTPSETrie::GetRuleSet(uint32_t id) const {
+  uint32_t length = 0;
+  if (static_cast<uint64_t>(id) + sizeof(length) > header_->rule_sets_size) {
+    return base::StringPiece();
+  }
+  memcpy(&length, rule_sets_ + id, sizeof(length));
+  if (static_cast<uint64_t>(id) + sizeof(length) + length >
+      header_->rule_sets_size) {
+    return base::StringPiece();
+  }
+  return base::StringPiece(
+      reinterpret_cast<const char*>(rule_sets_ + id + sizeof(length)),
+      length);
+}
+
+HTTPSETrieBuilder::Node::Node() : exact(kNoRuleSet), wildcard(kNoRuleSet) {
+}
+
+HTTPSETrieBuilder::Node::~Node() {
+}
+
+HTTPSETrieBuilder::HTTPSETrieBuilder() {
+}
+
+HTTPSETrieBuilder::~HTTPSETrieBuilder() {
+}
+
+uint32_t HTTPSETrieBuilder::AddRuleSet(const std::string& rule_set) {
+  auto it = rule_set_ids_.find(rule_set);
+  if (it != rule_set_ids_.end()) {
+    return it->second;
+  }
+  uint32_t id = rule_sets_.size();
+  uint32_t length = rule_set.size();
+  rule_sets_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+  rule_sets_.append(rule_set);
+  rule_set_ids_[rule_set] = id;
+  return id;
+}
+
+void HTTPSETrieBuilder::Add(const std::string& key,
+                            const std::string& rule_set) {
+  if (rule_set.empty()) {
+    return;
+  }
+  std::string host = key;
+  bool wildcard = base::EndsWith(host, kWildcardSuffix,
+                                 base::CompareCase::SENSITIVE);
+  if (wildcard) {
+    host.resize(host.size() - strlen(kWildcardSuffix));
+  }
+  if (host.empty()) {
+    return;
+  }
+
+  Node* node = &root_;
+  for (const std::string& label : base::SplitString(
+           host, ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL)) {
+    std::unique_ptr<Node>& child = node->children[label];
+    if (!child) {
+      child.reset(new Node());
+    }
+    node = child.get();
+  }
+  (wildcard ? node->wildcard : node->exact) = AddRuleSet(rule_set);
+}
+
+void HTTPSETrieBuilder::Serialize(std::string* output) const {
+  // Lay nodes out breadth first so that siblings end up contiguous.
+  std::vector<std::pair<const Node*, std::string>> order;
+  std::vector<HTTPSETrie::Node> nodes;
+  std::string labels;
+  base::queue<size_t> pending;
+  order.push_back(std::make_pair(&root_, std::string()));
+  pending.push(0);
+  while (!pending.empty()) {
+    size_t index = pending.front();
+    pending.pop();
+    const Node* node = order[index].first;
+    const std::string& label = order[index].second;
+
+    HTTPSETrie::Node serialized;
+    serialized.first_child = node->children.empty() ? 0 : order.size();
+    serialized.child_count = node->children.size();
+    serialized.label_offset = labels.size();
+    serialized.label_length = label.size();
+    serialized.exact = node->exact;
+    serialized.wildcard = node->wildcard;
+    labels.append(label);
+    nodes.push_back(serialized);
+
+    for (const auto& child : node->children) {
+      pending.push(order.size());
+      order.push_back(std::make_pair(child.second.get(), child.first));
+    }
+  }
+
+  HTTPSETrie::Header header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.node_count = nodes.size();
+  header.labels_size = labels.size();
+  header.rule_sets_size = rule_sets_.size();
+
+  output->clear();
+  output->reserve(sizeof(header) + nodes.size() * sizeof(HTTPSETrie::Node) +
+                  labels.size() + rule_sets_.size());
+  output->append(reinterpret_cast<const char*>(&header), sizeof(header));
+  output->append(reinterpret_cast<const char*>(nodes.data()),
+                 nodes.size() * sizeof(HTTPSETrie::Node));
+  output->append(labels);
+  output->append(rule_sets_);
+}
+
+// static
+bool HTTPSETrieBuilder::ConvertLevelDB(leveldb::DB* db,
+                                       const base::FilePath& path) {
+  HTTPSETrieBuilder builder;
+  std::unique_ptr<leveldb::Iterator> it(
+      db->NewIterator(leveldb::ReadOptions()));
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    builder.Add(it->key().ToString(), it->value().ToString());
+  }
+  if (!it->status().ok()) {
+    LOG(ERROR) << "HTTPSETrieBuilder: cannot read database, error: "
+               << it->status().ToString();
+    return false;
+  }
+
+  std::string data;
+  builder.Serialize(&data);
+  return base::ImportantFileWriter::WriteFileAtomically(path, data);
+}
+
+}  // namespace brave_shields
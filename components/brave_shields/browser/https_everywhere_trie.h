@@ -0,0 +1,113 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_TRIE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_TRIE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace leveldb {
+class DB;
+}
+
+namespace brave_shields {
+
+// Read-only label trie over reversed host names, stored in a memory mapped
+// file. Each node may point at the rule set for the exact host ("com.foo")
+// and at the rule set for its subdomains ("com.foo.*"), matching the keys of
+// the HTTPS Everywhere LevelDB database it is generated from.
+class HTTPSETrie {
+ public:
+  // Hosts can have at most 127 labels.
+  static const size_t kMaxLabels = 128;
+
+  // Rule set ids that apply to a host, most specific first.
+  struct Matches {
+    uint32_t ids[kMaxLabels];
+    size_t count;
+  };
+
+  ~HTTPSETrie();
+
+  // Returns nullptr if |path| does not exist or is not a valid trie file.
+  static std::unique_ptr<HTTPSETrie> Open(const base::FilePath& path);
+
+  // Walks the trie for |host| without allocating. The exact host match comes
+  // first, followed by wildcard matches from the longest suffix to the
+  // shortest one. The top level domain alone never matches.
+  void Find(base::StringPiece host, Matches* matches) const;
+
+  // Returns the JSON rule set for an id returned by Find().
+  base::StringPiece GetRuleSet(uint32_t id) const;
+
+ private:
+  friend class HTTPSETrieBuilder;
+  struct Header;
+  struct Node;
+
+  HTTPSETrie();
+
+  bool Validate();
+  const Node* GetChild(const Node* node, base::StringPiece label) const;
+  base::StringPiece GetLabel(const Node* node) const;
+
+  base::MemoryMappedFile file_;
+  const Header* header_;
+  const Node* nodes_;
+  const char* labels_;
+  const uint8_t* rule_sets_;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSETrie);
+};
+
+// Collects database keys and rule sets and serializes them in the format
+// read by HTTPSETrie.
+class HTTPSETrieBuilder {
+ public:
+  HTTPSETrieBuilder();
+  ~HTTPSETrieBuilder();
+
+  // |key| is a reversed host name, optionally ending with ".*".
+  void Add(const std::string& key, const std::string& rule_set);
+
+  void Serialize(std::string* output) const;
+
+  // Converts every entry of |db| and atomically writes the result to |path|.
+  static bool ConvertLevelDB(leveldb::DB* db, const base::FilePath& path);
+
+ private:
+  struct Node {
+    Node();
+    ~Node();
+
+    std::map<std::string, std::unique_ptr<Node>> children;
+    uint32_t exact;
+    uint32_t wildcard;
+  };
+
+  uint32_t AddRuleSet(const std::string& rule_set);
+
+  Node root_;
+  std::map<std::string, uint32_t> rule_set_ids_;
+  std::string rule_sets_;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSETrieBuilder);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_TRIE_H_
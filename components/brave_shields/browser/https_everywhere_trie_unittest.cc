@@ -0,0 +1,82 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_trie.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::HTTPSETrie;
+using brave_shields::HTTPSETrieBuilder;
+
+namespace {
+
+std::unique_ptr<HTTPSETrie> WriteAndOpen(const HTTPSETrieBuilder& builder,
+                                         const base::ScopedTempDir& dir) {
+  std::string data;
+  builder.Serialize(&data);
+  base::FilePath path = dir.GetPath().AppendASCII("httpse.trie");
+  EXPECT_EQ(static_cast<int>(data.size()),
+            base::WriteFile(path, data.data(), data.size()));
+  return HTTPSETrie::Open(path);
+}
+
+std::vector<std::string> Find(const HTTPSETrie& trie,
+                              const std::string& host) {
+  HTTPSETrie::Matches matches;
+  trie.Find(host, &matches);
+  std::vector<std::string> result;
+  for (size_t i = 0; i < matches.count; ++i) {
+    result.push_back(trie.GetRuleSet(matches.ids[i]).as_string());
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(HTTPSETrieTest, FindMatchesLookupOrder) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+
+  HTTPSETrieBuilder builder;
+  builder.Add("com.foo", "exact");
+  builder.Add("com.foo.*", "foo_wildcard");
+  builder.Add("com.foo.bar.*", "bar_wildcard");
+  builder.Add("com.foo.bar.www", "www_exact");
+  builder.Add("com.*", "never");
+  std::unique_ptr<HTTPSETrie> trie = WriteAndOpen(builder, dir);
+  ASSERT_TRUE(trie);
+
+  EXPECT_EQ(std::vector<std::string>({"exact"}), Find(*trie, "foo.com"));
+  EXPECT_EQ(std::vector<std::string>({"www_exact", "bar_wildcard",
+                                      "foo_wildcard"}),
+            Find(*trie, "www.bar.foo.com"));
+  EXPECT_EQ(std::vector<std::string>({"bar_wildcard", "foo_wildcard"}),
+            Find(*trie, "a.b.bar.foo.com"));
+  EXPECT_EQ(std::vector<std::string>({"foo_wildcard"}),
+            Find(*trie, "other.foo.com."));
+  EXPECT_TRUE(Find(*trie, "com").empty());
+  EXPECT_TRUE(Find(*trie, "example.com").empty());
+  EXPECT_TRUE(Find(*trie, "").empty());
+}
+
+TEST(HTTPSETrieTest, RejectsCorruptedFile) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath path = dir.GetPath().AppendASCII("httpse.trie");
+  EXPECT_FALSE(HTTPSETrie::Open(path));
+
+  HTTPSETrieBuilder builder;
+  builder.Add("com.foo", "exact");
+  std::string data;
+  builder.Serialize(&data);
+  data.resize(data.size() - 1);
+  ASSERT_EQ(static_cast<int>(data.size()),
+            base::WriteFile(path, data.data(), data.size()));
+  EXPECT_FALSE(HTTPSETrie::Open(path));
+}
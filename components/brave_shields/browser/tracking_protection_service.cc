@@ -4,7 +4,6 @@
 
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 
-#include <algorithm>
 #include <utility>
 
 #include "base/base_paths.h"
@@ -12,7 +11,9 @@
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/strings/string_split.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task_runner_util.h"
 #include "base/threading/thread_restrictions.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
@@ -21,19 +22,26 @@
 
 #define DAT_FILE "TrackingProtection.dat"
 #define DAT_FILE_VERSION "1"
-#define THIRD_PARTY_HOSTS_CACHE_SIZE 20
+#define THIRD_PARTY_HOSTS_CACHE_SIZE 500
 
 namespace brave_shields {
 
+ThirdPartyHosts::ThirdPartyHosts(base::StringPiece hosts)
+    : hosts_(base::SplitString(hosts, ",", base::KEEP_WHITESPACE,
+                               base::SPLIT_WANT_NONEMPTY)) {
+}
+
+ThirdPartyHosts::~ThirdPartyHosts() {
+}
+
 std::string TrackingProtectionService::g_tracking_protection_component_id_(
     kTrackingProtectionComponentId);
 std::string TrackingProtectionService::g_tracking_protection_component_base64_public_key_(
     kTrackingProtectionComponentBase64PublicKey);
 
 TrackingProtectionService::TrackingProtectionService()
-  : tracking_protection_client_(new CTPParser()),
     // See comment in tracking_protection_service.h for white_list_
-    white_list_({
+  : white_list_({
       "connect.facebook.net",
       "connect.facebook.com",
       "staticxx.facebook.com",
@@ -45,8 +53,9 @@ TrackingProtectionService::TrackingProtectionService()
       "syndication.twitter.com",
       "cdn.syndication.twimg.com"
     }),
+    third_party_hosts_cache_(THIRD_PARTY_HOSTS_CACHE_SIZE),
+    third_party_hosts_client_(nullptr),
     weak_factory_(this) {
-  DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 TrackingProtectionService::~TrackingProtectionService() {
@@ -54,40 +63,46 @@ TrackingProtectionService::~TrackingProtectionService() {
 }
 
 void TrackingProtectionService::Cleanup() {
-  tracking_protection_client_.reset();
+  scoped_refptr<DATFileClient<CTPParser>> old_tracking_protection_client;
+  {
+    base::AutoLock lock(tracking_protection_client_lock_);
+    old_tracking_protection_client = std::move(tracking_protection_client_);
+  }
+  // Released outside of the lock, see AdBlockBaseService::Cleanup().
+}
+
+scoped_refptr<DATFileClient<CTPParser>>
+TrackingProtectionService::GetTrackingProtectionClient() {
+  base::AutoLock lock(tracking_protection_client_lock_);
+  return tracking_protection_client_;
 }
 
 bool TrackingProtectionService::ShouldStartRequest(const GURL& url,
     content::ResourceType resource_type,
     const std::string &tab_host) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  std::string host = url.host();
-  if (!tracking_protection_client_->matchesTracker(
-        tab_host.c_str(), host.c_str())) {
+  scoped_refptr<DATFileClient<CTPParser>> tracking_protection_client =
+      GetTrackingProtectionClient();
+  if (!tracking_protection_client) {
     return true;
   }
-
-  std::vector<std::string> hosts(GetThirdPartyHosts(tab_host));
-  for (size_t i = 0; i < hosts.size(); i++) {
-    if (host == hosts[i] ||
-        host.find((std::string)"." + hosts[i]) != std::string::npos) {
-      return true;
-    }
-    size_t iPos = host.find((std::string)"." + hosts[i]);
-    if (iPos == std::string::npos) {
-      continue;
-    }
-    if (hosts[i].length() + ((std::string)".").length() + iPos ==
-        host.length()) {
+  const std::string host = url.host();
+  {
+    DATFileClient<CTPParser>::ScopedClient client(
+        tracking_protection_client.get());
+    if (!client ||
+        !client->matchesTracker(tab_host.c_str(), host.c_str())) {
       return true;
     }
   }
 
-  if (std::find(white_list_.begin(), white_list_.end(), host) !=
-      white_list_.end()) {
+  scoped_refptr<const ThirdPartyHosts> hosts =
+      GetThirdPartyHosts(tracking_protection_client.get(), tab_host);
+  if (hosts->Contains(host)) {
     return true;
   }
-  return false;
+
+  // The allow list names exact hosts, so subdomains do not match.
+  return white_list_.MatchesExactly(host);
 }
 
 bool TrackingProtectionService::Init() {
@@ -97,16 +112,26 @@ bool TrackingProtectionService::Init() {
   return true;
 }
 
-void TrackingProtectionService::OnDATFileDataReady() {
-  if (buffer_.empty()) {
-    LOG(ERROR) << "Could not obtain tracking protection data";
+void TrackingProtectionService::OnDATFileDataReady(
+    scoped_refptr<DATFileClient<CTPParser>> tracking_protection_client) {
+  if (!tracking_protection_client) {
+    // Keep matching against the previous list, if any.
+    LOG(ERROR) << "Could not load tracking protection data";
     return;
   }
-  tracking_protection_client_.reset(new CTPParser());
-  if (!tracking_protection_client_->deserialize((char*)&buffer_.front())) {
-    tracking_protection_client_.reset();
-    LOG(ERROR) << "Failed to deserialize tracking protection data";
+  {
+    // Cached host lists came from the previous list. Matches still using it
+    // must not cache theirs from now on.
+    base::AutoLock lock(third_party_hosts_lock_);
+    third_party_hosts_cache_.Clear();
+    third_party_hosts_client_ = tracking_protection_client.get();
+  }
+  {
+    base::AutoLock lock(tracking_protection_client_lock_);
+    tracking_protection_client_.swap(tracking_protection_client);
   }
+  // |tracking_protection_client| now holds the previous list, which is
+  // released outside of the lock.
 }
 
 void TrackingProtectionService::OnComponentReady(
@@ -116,66 +141,45 @@ void TrackingProtectionService::OnComponentReady(
   base::FilePath dat_file_path =
       install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(DAT_FILE);
 
-  GetTaskRunner()->PostTaskAndReply(
+  base::PostTaskAndReplyWithResult(
+      GetTaskRunner().get(),
       FROM_HERE,
-      base::Bind(&GetDATFileData, dat_file_path, &buffer_),
-      base::Bind(&TrackingProtectionService::OnDATFileDataReady,
-                 weak_factory_.GetWeakPtr()));
+      base::BindOnce(&LoadDATFileClient<CTPParser>, dat_file_path),
+      base::BindOnce(&TrackingProtectionService::OnDATFileDataReady,
+                     weak_factory_.GetWeakPtr()));
 }
 
 // Ported from Android: net/blockers/blockers_worker.cc
-std::vector<std::string>
-TrackingProtectionService::GetThirdPartyHosts(const std::string& base_host) {
+scoped_refptr<const ThirdPartyHosts>
+TrackingProtectionService::GetThirdPartyHosts(
+    DATFileClient<CTPParser>* client,
+    const std::string& base_host) {
   {
-    std::lock_guard<std::mutex> guard(third_party_hosts_mutex_);
-    std::map<std::string, std::vector<std::string>>::const_iterator iter =
-      third_party_hosts_cache_.find(base_host);
-    if (third_party_hosts_cache_.end() != iter) {
-      if (third_party_base_hosts_.size() != 0
-          && third_party_base_hosts_[third_party_hosts_cache_.size() - 1] !=
-          base_host) {
-        for (size_t i = 0; i < third_party_base_hosts_.size(); i++) {
-          if (third_party_base_hosts_[i] == base_host) {
-            third_party_base_hosts_.erase(third_party_base_hosts_.begin() + i);
-            third_party_base_hosts_.push_back(base_host);
-            break;
-          }
-        }
+    base::AutoLock lock(third_party_hosts_lock_);
+    if (client == third_party_hosts_client_) {
+      auto it = third_party_hosts_cache_.Get(base_host);
+      if (it != third_party_hosts_cache_.end()) {
+        return it->second;
       }
-      return iter->second;
     }
   }
 
-  char* thirdPartyHosts =
-    tracking_protection_client_->findFirstPartyHosts(base_host.c_str());
-  std::vector<std::string> hosts;
-  if (nullptr != thirdPartyHosts) {
-    std::string strThirdPartyHosts = thirdPartyHosts;
-    size_t iPos = strThirdPartyHosts.find(",");
-    while (iPos != std::string::npos) {
-      std::string thirdParty = strThirdPartyHosts.substr(0, iPos);
-      strThirdPartyHosts = strThirdPartyHosts.substr(iPos + 1);
-      iPos = strThirdPartyHosts.find(",");
-      hosts.push_back(thirdParty);
-    }
-    if (0 != strThirdPartyHosts.length()) {
-      hosts.push_back(strThirdPartyHosts);
-    }
-    delete []thirdPartyHosts;
-  }
-
+  char* third_party_hosts = nullptr;
   {
-    std::lock_guard<std::mutex> guard(third_party_hosts_mutex_);
-    if (third_party_hosts_cache_.size() == THIRD_PARTY_HOSTS_CACHE_SIZE &&
-        third_party_base_hosts_.size() == THIRD_PARTY_HOSTS_CACHE_SIZE) {
-      third_party_hosts_cache_.erase(third_party_base_hosts_[0]);
-      third_party_base_hosts_.erase(third_party_base_hosts_.begin());
+    DATFileClient<CTPParser>::ScopedClient scoped_client(client);
+    if (scoped_client) {
+      third_party_hosts = scoped_client->findFirstPartyHosts(
+          base_host.c_str());
     }
-    third_party_base_hosts_.push_back(base_host);
-    third_party_hosts_cache_.insert(
-        std::pair<std::string, std::vector<std::string>>(base_host, hosts));
   }
+  scoped_refptr<const ThirdPartyHosts> hosts = base::MakeRefCounted<
+      ThirdPartyHosts>(third_party_hosts ? third_party_hosts : "");
+  delete []third_party_hosts;
 
+  base::AutoLock lock(third_party_hosts_lock_);
+  if (client == third_party_hosts_client_) {
+    third_party_hosts_cache_.Put(base_host, hosts);
+  }
   return hosts;
 }
 
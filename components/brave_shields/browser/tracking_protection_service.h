@@ -7,17 +7,19 @@
 
 #include <stdint.h>
 
-#include <map>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
-#include "base/sequence_checker.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/host_suffix_matcher.h"
 #include "content/public/common/resource_type.h"
 
 class CTPParser;
@@ -37,12 +39,34 @@ const std::string kTrackingProtectionComponentBase64PublicKey =
     "EGL1V7GeI4vgLoOLgq7tmhEratHGCfC1IHm9luMACRr/ybMI6DQJOvgBvecb292F"
     "xQIDAQAB";
 
+// Hosts that a first party host is allowed to load trackers from. Immutable,
+// and shared between the cache and the requests that use it.
+class ThirdPartyHosts : public base::RefCountedThreadSafe<ThirdPartyHosts> {
+ public:
+  // |hosts| is the comma separated list returned by the parser.
+  explicit ThirdPartyHosts(base::StringPiece hosts);
+
+  // True if |host| is one of the hosts or a subdomain of one of them.
+  bool Contains(base::StringPiece host) const {
+    return hosts_.Matches(host);
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<ThirdPartyHosts>;
+  ~ThirdPartyHosts();
+
+  const HostSuffixMatcher hosts_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThirdPartyHosts);
+};
+
 // The brave shields service in charge of tracking protection and init.
 class TrackingProtectionService : public BaseBraveShieldsService {
  public:
   TrackingProtectionService();
   ~TrackingProtectionService() override;
 
+  // Can be called from any thread, see AdBlockBaseService.
   bool ShouldStartRequest(const GURL& spec,
     content::ResourceType resource_type,
     const std::string& tab_host) override;
@@ -63,19 +87,25 @@ class TrackingProtectionService : public BaseBraveShieldsService {
       const std::string& component_id,
       const std::string& component_base64_public_key);
 
-  void OnDATFileDataReady();
-  std::vector<std::string> GetThirdPartyHosts(const std::string& base_host);
-
-  brave_shields::DATFileDataBuffer buffer_;
+  void OnDATFileDataReady(
+      scoped_refptr<DATFileClient<CTPParser>> tracking_protection_client);
+  scoped_refptr<DATFileClient<CTPParser>> GetTrackingProtectionClient();
+  scoped_refptr<const ThirdPartyHosts> GetThirdPartyHosts(
+      DATFileClient<CTPParser>* client,
+      const std::string& base_host);
 
-  std::unique_ptr<CTPParser> tracking_protection_client_;
+  scoped_refptr<DATFileClient<CTPParser>> tracking_protection_client_;
+  base::Lock tracking_protection_client_lock_;
   // TODO: Temporary hack which matches both browser-laptop and Android code
-  std::vector<std::string> white_list_;
-  std::vector<std::string> third_party_base_hosts_;
-  std::map<std::string, std::vector<std::string>> third_party_hosts_cache_;
-  std::mutex third_party_hosts_mutex_;
+  const HostSuffixMatcher white_list_;
+  // Keyed by first party host.
+  base::HashingMRUCache<std::string, scoped_refptr<const ThirdPartyHosts>>
+      third_party_hosts_cache_;
+  // The list the cached hosts were found in, only compared against the list
+  // of a match so that one still using a replaced list does not cache.
+  const DATFileClient<CTPParser>* third_party_hosts_client_;
+  base::Lock third_party_hosts_lock_;
 
-  SEQUENCE_CHECKER(sequence_checker_);
   base::WeakPtrFactory<TrackingProtectionService> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(TrackingProtectionService);
 };
@@ -4,11 +4,31 @@
 
 #include "brave/components/brave_sync/bookmark_order_util.h"
 
+#include <limits>
+
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 
 namespace brave_sync {
 
+namespace {
+
+// Appends the number of significant bytes of |value| followed by these bytes
+// in big-endian order, so shorter numbers sort first and numbers of the same
+// length sort bytewise.
+void AppendKeyComponent(uint32_t value, std::string* key) {
+  char bytes[sizeof(value)];
+  size_t size = 0;
+  for (; value; value >>= 8)
+    bytes[size++] = static_cast<char>(value & 0xff);
+  key->push_back(static_cast<char>(size));
+  while (size)
+    key->push_back(bytes[--size]);
+}
+
+}  // namespace
+
 std::vector<int> OrderToIntVect(const std::string& s) {
   std::vector<std::string> vec_s = SplitString(
       s,
@@ -27,14 +47,39 @@ std::vector<int> OrderToIntVect(const std::string& s) {
   return vec_int;
 }
 
+std::string OrderToKey(const std::string& order) {
+  std::string key;
+  key.reserve(order.size() * 2);
+
+  uint64_t value = 0;
+  bool has_digits = false;
+  for (const char c : order) {
+    if (base::IsAsciiDigit(c)) {
+      value = value * 10 + (c - '0');
+      CHECK(value <= static_cast<uint64_t>(std::numeric_limits<int>::max()));
+      has_digits = true;
+    } else if (c == '.') {
+      if (has_digits)
+        AppendKeyComponent(static_cast<uint32_t>(value), &key);
+      value = 0;
+      has_digits = false;
+    } else {
+      // whitespace or an invalid order, leave it to the full parser
+      key.clear();
+      for (const int component : OrderToIntVect(order))
+        AppendKeyComponent(static_cast<uint32_t>(component), &key);
+      return key;
+    }
+  }
+  if (has_digits)
+    AppendKeyComponent(static_cast<uint32_t>(value), &key);
+
+  return key;
+}
+
 bool CompareOrder(const std::string& left, const std::string& right) {
   // Return: true if left <  right
-  // Split each and use C++ stdlib
-  std::vector<int> vec_left = OrderToIntVect(left);
-  std::vector<int> vec_right = OrderToIntVect(right);
-
-  return std::lexicographical_compare(vec_left.begin(), vec_left.end(),
-    vec_right.begin(), vec_right.end());
+  return OrderToKey(left) < OrderToKey(right);
 }
 
 } // namespace brave_sync
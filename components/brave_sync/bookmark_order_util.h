@@ -11,6 +11,10 @@
 namespace brave_sync {
 
   std::vector<int> OrderToIntVect(const std::string& s);
+  // Returns a byte string which compares with operator< the same way as
+  // CompareOrder compares |order|, so an order can be parsed once and then
+  // compared many times.
+  std::string OrderToKey(const std::string& order);
   bool CompareOrder(const std::string& left, const std::string& right);
 
 } // namespace brave_sync
@@ -4,6 +4,8 @@
 
 #include "brave/components/brave_sync/bookmark_order_util.h"
 
+#include <algorithm>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace brave_sync {
@@ -60,4 +62,35 @@ TEST_F(BookmarkOrderUtilTest, CompareOrder) {
   EXPECT_FALSE(CompareOrder("1.7.0.2", "1.7.0.1"));
 }
 
+TEST_F(BookmarkOrderUtilTest, OrderToKey) {
+  EXPECT_TRUE(OrderToKey("").empty());
+  EXPECT_EQ(OrderToKey("1.7.4"), OrderToKey(" 1 . 7 .4"));
+  EXPECT_EQ(OrderToKey(".5."), OrderToKey("5"));
+  EXPECT_EQ(OrderToKey("01.2"), OrderToKey("1.2"));
+
+  EXPECT_LT(OrderToKey("255"), OrderToKey("256"));
+  EXPECT_LT(OrderToKey("256"), OrderToKey("65536"));
+  EXPECT_LT(OrderToKey("0"), OrderToKey("1"));
+  EXPECT_LT(OrderToKey("1"), OrderToKey("1.0"));
+  EXPECT_LT(OrderToKey("1.2147483647"), OrderToKey("2"));
+}
+
+TEST_F(BookmarkOrderUtilTest, OrderToKeyMatchesIntVect) {
+  const std::vector<std::string> orders = {
+      "", "0", "1", "1.0", "1.1", "1.1.1", "1.7.0.1", "1.7.1", "2", "11",
+      "127", "128", "255", "256", "257", "65535", "65536", "16777216",
+      "2.234.1", "63.17.1.45.2", "2147483647", "2147483647.1"};
+  for (const auto& left : orders) {
+    for (const auto& right : orders) {
+      const std::vector<int> vec_left = OrderToIntVect(left);
+      const std::vector<int> vec_right = OrderToIntVect(right);
+      EXPECT_EQ(std::lexicographical_compare(vec_left.begin(), vec_left.end(),
+                                             vec_right.begin(),
+                                             vec_right.end()),
+                OrderToKey(left) < OrderToKey(right))
+          << left << " < " << right;
+    }
+  }
+}
+
 } // namespace brave_sync
@@ -24,21 +24,6 @@ using bookmarks::BookmarkModel;
 
 namespace {
 
-class ScopedPauseObserver {
- public:
-  ScopedPauseObserver(brave_sync::BookmarkChangeProcessor* processor) :
-      processor_(processor) {
-    DCHECK_NE(processor_, nullptr);
-    processor_->Stop();
-  }
-  ~ScopedPauseObserver() {
-    processor_->Start();
-  }
-
- private:
-  brave_sync::BookmarkChangeProcessor* processor_;  // Not owned
-};
-
 const char kDeletedBookmarksTitle[] = "Deleted Bookmarks";
 const char kPendingBookmarksTitle[] = "Pending Bookmarks";
 
@@ -57,6 +42,25 @@ std::unique_ptr<brave_sync::BraveBookmarkPermanentNode>
 
 namespace brave_sync {
 
+// Unlike Stop() and Start(), pausing keeps the object_id index, so code that
+// changes object ids while paused has to update it itself.
+class ScopedPauseObserver {
+ public:
+  ScopedPauseObserver(BookmarkChangeProcessor* processor) :
+      processor_(processor) {
+    DCHECK_NE(processor_, nullptr);
+    if (processor_->bookmark_model_)
+      processor_->bookmark_model_->RemoveObserver(processor_);
+  }
+  ~ScopedPauseObserver() {
+    if (processor_->bookmark_model_)
+      processor_->bookmark_model_->AddObserver(processor_);
+  }
+
+ private:
+  BookmarkChangeProcessor* processor_;  // Not owned
+};
+
 bool IsSyncManagedNodeDeleted(const bookmarks::BookmarkPermanentNode* node) {
   return node->GetTitledUrlNodeTitle() ==
       base::UTF8ToUTF16(kDeletedBookmarksTitle);
@@ -124,8 +128,9 @@ void GetPrevObjectId(const bookmarks::BookmarkNode* parent,
     prev_node->GetMetaInfo("object_id", prev_object_id);
 }
 
-const bookmarks::BookmarkNode* FindByObjectId(bookmarks::BookmarkModel* model,
-                                        const std::string& object_id) {
+const bookmarks::BookmarkNode* FindByObjectIdInTree(
+    bookmarks::BookmarkModel* model,
+    const std::string& object_id) {
   ui::TreeNodeIterator<const bookmarks::BookmarkNode>
       iterator(model->root_node());
   while (iterator.has_next()) {
@@ -139,19 +144,34 @@ const bookmarks::BookmarkNode* FindByObjectId(bookmarks::BookmarkModel* model,
   return nullptr;
 }
 
+// Returns the index of the first child ordered after |record_order|, children
+// without order are skipped. Children are kept sorted by order, so this is a
+// binary search which only parses the orders it probes.
 uint64_t GetIndexByOrder(const bookmarks::BookmarkNode* root_node,
                   const std::string& record_order) {
-  int index = 0;
-  while (index < root_node->child_count()) {
-    const bookmarks::BookmarkNode* node = root_node->GetChild(index);
+  const std::string record_key = brave_sync::OrderToKey(record_order);
+  int index = root_node->child_count();
+  int low = 0;
+  int high = root_node->child_count();
+  while (low < high) {
+    const int middle = low + (high - low) / 2;
+    int probe = middle;
     std::string node_order;
-    node->GetMetaInfo("order", &node_order);
-
-    if (!node_order.empty() &&
-        brave_sync::CompareOrder(record_order, node_order))
-      return index;
+    for (; probe < high; ++probe) {
+      root_node->GetChild(probe)->GetMetaInfo("order", &node_order);
+      if (!node_order.empty())
+        break;
+    }
 
-    ++index;
+    if (probe == high) {
+      // [middle, high) has no ordered children
+      high = middle;
+    } else if (record_key < brave_sync::OrderToKey(node_order)) {
+      index = probe;
+      high = middle;
+    } else {
+      low = probe + 1;
+    }
   }
   return index;
 }
@@ -196,34 +216,6 @@ void UpdateNode(bookmarks::BookmarkModel* model,
   }
 }
 
-const bookmarks::BookmarkNode* FindParent(bookmarks::BookmarkModel* model,
-                                          const jslib::Bookmark& bookmark,
-                                          bookmarks::BookmarkNode*
-                                                            pending_node_root) {
-  auto* parent_node = FindByObjectId(model, bookmark.parentFolderObjectId);
-
-  if (!parent_node) {
-    if (!bookmark.parentFolderObjectId.empty()) {
-      return pending_node_root;
-    }
-    if (
-        // this flag is a bit odd, but if the node doesn't have a parent and
-        // hideInToolbar is false, then this bookmark should go in the
-        // toolbar root. We don't care about this flag for records with
-        // a parent id because they will be inserted into the correct
-        // parent folder
-        !bookmark.hideInToolbar ||
-        // mobile generated bookmarks go also in bookmark bar
-        (!bookmark.order.empty() && bookmark.order.at(0) == '2')) {
-      parent_node = model->bookmark_bar_node();
-    } else {
-      parent_node = model->other_node();
-    }
-  }
-
-  return parent_node;
-}
-
 }  // namespace
 
 // static
@@ -244,7 +236,10 @@ BookmarkChangeProcessor::BookmarkChangeProcessor(
       bookmark_model_(BookmarkModelFactory::GetForBrowserContext(
           Profile::FromBrowserContext(profile))),
       deleted_node_root_(nullptr),
-      pending_node_root_(nullptr) {
+      pending_node_root_(nullptr),
+      observing_(false),
+      object_id_index_valid_(false),
+      dirty_nodes_valid_(false) {
   DCHECK(sync_client_);
   DCHECK(sync_prefs);
   DCHECK(bookmark_model_);
@@ -256,27 +251,213 @@ BookmarkChangeProcessor::~BookmarkChangeProcessor() {
 
 void BookmarkChangeProcessor::Start() {
   bookmark_model_->AddObserver(this);
+  observing_ = true;
+  // the model may have changed while stopped
+  InvalidateObjectIdIndex();
+  InvalidateDirtyNodes();
 }
 
 void BookmarkChangeProcessor::Stop() {
   if (bookmark_model_)
     bookmark_model_->RemoveObserver(this);
+  observing_ = false;
+  InvalidateObjectIdIndex();
+  InvalidateDirtyNodes();
+}
+
+const bookmarks::BookmarkNode* BookmarkChangeProcessor::FindByObjectId(
+    const std::string& object_id) {
+  if (object_id.empty())
+    return nullptr;
+
+  if (!observing_)
+    return FindByObjectIdInTree(bookmark_model_, object_id);
+
+  if (!object_id_index_valid_)
+    BuildObjectIdIndex();
+
+  auto it = object_id_index_.find(object_id);
+  if (it == object_id_index_.end())
+    return nullptr;
+
+  std::string node_object_id;
+  it->second->GetMetaInfo("object_id", &node_object_id);
+  if (node_object_id == object_id)
+    return it->second;
+
+  // the node got another object_id since it was indexed
+  BuildObjectIdIndex();
+  it = object_id_index_.find(object_id);
+  return it == object_id_index_.end() ? nullptr : it->second;
+}
+
+void BookmarkChangeProcessor::BuildObjectIdIndex() {
+  object_id_index_.clear();
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode>
+      iterator(bookmark_model_->root_node());
+  while (iterator.has_next()) {
+    const bookmarks::BookmarkNode* node = iterator.Next();
+    std::string object_id;
+    node->GetMetaInfo("object_id", &object_id);
+    // keep the first node in tree order, as the full tree walk used to
+    if (!object_id.empty())
+      object_id_index_.emplace(object_id, node);
+  }
+  object_id_index_valid_ = true;
+}
+
+void BookmarkChangeProcessor::InvalidateObjectIdIndex() {
+  object_id_index_.clear();
+  object_id_index_valid_ = false;
+}
+
+void BookmarkChangeProcessor::UpdateObjectIdIndex(
+    const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_valid_)
+    return;
+
+  std::string object_id;
+  node->GetMetaInfo("object_id", &object_id);
+  if (!object_id.empty())
+    object_id_index_[object_id] = node;
+}
+
+void BookmarkChangeProcessor::AddToObjectIdIndex(
+    const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_valid_)
+    return;
+
+  UpdateObjectIdIndex(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    UpdateObjectIdIndex(iterator.Next());
+}
+
+void BookmarkChangeProcessor::RemoveFromObjectIdIndex(
+    const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_valid_)
+    return;
+
+  auto remove = [this](const bookmarks::BookmarkNode* node) {
+    std::string object_id;
+    node->GetMetaInfo("object_id", &object_id);
+    auto it = object_id_index_.find(object_id);
+    if (it != object_id_index_.end() && it->second == node)
+      object_id_index_.erase(it);
+  };
+  remove(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    remove(iterator.Next());
+}
+
+void BookmarkChangeProcessor::InvalidateDirtyNodes() {
+  dirty_nodes_.clear();
+  retry_queue_.clear();
+  retry_times_.clear();
+  dirty_nodes_valid_ = false;
+}
+
+void BookmarkChangeProcessor::MarkDirty(const bookmarks::BookmarkNode* node) {
+  if (!dirty_nodes_valid_)
+    return;
+
+  DequeueRetry(node);
+  dirty_nodes_.insert(node);
+}
+
+void BookmarkChangeProcessor::AddToDirtyNodes(
+    const bookmarks::BookmarkNode* node) {
+  if (!dirty_nodes_valid_)
+    return;
+
+  MarkDirty(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    MarkDirty(iterator.Next());
+}
+
+void BookmarkChangeProcessor::RemoveFromDirtyNodes(
+    const bookmarks::BookmarkNode* node) {
+  if (!dirty_nodes_valid_)
+    return;
+
+  DequeueRetry(node);
+  dirty_nodes_.erase(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next()) {
+    const bookmarks::BookmarkNode* child = iterator.Next();
+    DequeueRetry(child);
+    dirty_nodes_.erase(child);
+  }
+}
+
+void BookmarkChangeProcessor::QueueRetry(const bookmarks::BookmarkNode* node,
+                                         base::Time send_time) {
+  if (!dirty_nodes_valid_)
+    return;
+
+  DequeueRetry(node);
+  retry_queue_.insert(std::make_pair(send_time, node));
+  retry_times_[node] = send_time;
+}
+
+void BookmarkChangeProcessor::DequeueRetry(
+    const bookmarks::BookmarkNode* node) {
+  auto it = retry_times_.find(node);
+  if (it == retry_times_.end())
+    return;
+
+  retry_queue_.erase(std::make_pair(it->second, node));
+  retry_times_.erase(it);
+}
+
+const bookmarks::BookmarkNode* BookmarkChangeProcessor::FindParent(
+    const jslib::Bookmark& bookmark) {
+  auto* parent_node = FindByObjectId(bookmark.parentFolderObjectId);
+
+  if (!parent_node) {
+    if (!bookmark.parentFolderObjectId.empty()) {
+      return GetPendingNodeRoot();
+    }
+    if (
+        // this flag is a bit odd, but if the node doesn't have a parent and
+        // hideInToolbar is false, then this bookmark should go in the
+        // toolbar root. We don't care about this flag for records with
+        // a parent id because they will be inserted into the correct
+        // parent folder
+        !bookmark.hideInToolbar ||
+        // mobile generated bookmarks go also in bookmark bar
+        (!bookmark.order.empty() && bookmark.order.at(0) == '2')) {
+      parent_node = bookmark_model_->bookmark_bar_node();
+    } else {
+      parent_node = bookmark_model_->other_node();
+    }
+  }
+
+  return parent_node;
 }
 
 void BookmarkChangeProcessor::BookmarkModelLoaded(BookmarkModel* model,
                                                   bool ids_reassigned) {
   // This may be invoked after bookmarks import
   VLOG(1) << __func__;
+  InvalidateObjectIdIndex();
+  InvalidateDirtyNodes();
 }
 
 void BookmarkChangeProcessor::BookmarkModelBeingDeleted(bookmarks::BookmarkModel* model) {
   NOTREACHED();
+  InvalidateObjectIdIndex();
+  InvalidateDirtyNodes();
   bookmark_model_ = nullptr;
 }
 
 void BookmarkChangeProcessor::BookmarkNodeAdded(BookmarkModel* model,
                                                 const BookmarkNode* parent,
                                                 int index) {
+  AddToObjectIdIndex(parent->GetChild(index));
+  AddToDirtyNodes(parent->GetChild(index));
 }
 
 void BookmarkChangeProcessor::OnWillRemoveBookmarks(BookmarkModel* model,
@@ -323,6 +504,7 @@ void BookmarkChangeProcessor::CloneBookmarkNodeForDelete(
   for (size_t i = 0; i < elements.size(); ++i) {
     CloneBookmarkNodeForDeleteImpl(
         elements[i], parent, index + static_cast<int>(i));
+    AddToObjectIdIndex(parent->GetChild(index + static_cast<int>(i)));
   }
 }
 
@@ -332,6 +514,9 @@ void BookmarkChangeProcessor::BookmarkNodeRemoved(
     int old_index,
     const BookmarkNode* node,
     const std::set<GURL>& no_longer_bookmarked) {
+  RemoveFromObjectIdIndex(node);
+  RemoveFromDirtyNodes(node);
+
   // TODO(bridiver) - should this be in OnWillRemoveBookmarks?
   // copy into the deleted node tree without firing any events
 
@@ -354,10 +539,13 @@ void BookmarkChangeProcessor::BookmarkAllUserNodesRemoved(
     const std::set<GURL>& removed_urls) {
   // this only happens on profile deletion and we don't want
   // to wipe out the remote store when that happens
+  InvalidateObjectIdIndex();
+  InvalidateDirtyNodes();
 }
 
 void BookmarkChangeProcessor::BookmarkNodeChanged(BookmarkModel* model,
                                                   const BookmarkNode* node) {
+  MarkDirty(node);
   ScopedPauseObserver pause(this);
   // clearing the sync_timestamp will put the record back in the `Unsynced` list
   model->DeleteNodeMetaInfo(node, "sync_timestamp");
@@ -371,6 +559,7 @@ void BookmarkChangeProcessor::BookmarkNodeChanged(BookmarkModel* model,
 
 void BookmarkChangeProcessor::BookmarkMetaInfoChanged(
     BookmarkModel* model, const BookmarkNode* node) {
+  UpdateObjectIdIndex(node);
   BookmarkNodeChanged(model, node);
 }
 
@@ -378,6 +567,7 @@ void BookmarkChangeProcessor::BookmarkNodeMoved(BookmarkModel* model,
       const BookmarkNode* old_parent, int old_index,
       const BookmarkNode* new_parent, int new_index) {
   auto* node = new_parent->GetChild(new_index);
+  MarkDirty(node);
   model->DeleteNodeMetaInfo(node, "order");
   // TODO(darkdh): handle old_parent == new_parent to avoid duplicate order
   // clearing. Also https://github.com/brave/sync/issues/231 blocks update to
@@ -429,6 +619,8 @@ void BookmarkChangeProcessor::Reset(bool clear_meta_info) {
   CHECK(pending_node);
   pending_node->DeleteAll();
   bookmark_model_->EndExtensiveChanges();
+  InvalidateObjectIdIndex();
+  InvalidateDirtyNodes();
 }
 
 void BookmarkChangeProcessor::DeleteSelfAndChildren(
@@ -495,7 +687,7 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
     DCHECK(sync_record->has_bookmark());
     DCHECK(!sync_record->objectId.empty());
 
-    auto* node = FindByObjectId(bookmark_model_, sync_record->objectId);
+    auto* node = FindByObjectId(sync_record->objectId);
     auto bookmark_record = sync_record->GetBookmark();
 
     if (node && sync_record->action == jslib::SyncRecord::Action::A_UPDATE) {
@@ -510,8 +702,7 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
 
       const bookmarks::BookmarkNode* new_parent_node = nullptr;
       if (bookmark_record.parentFolderObjectId != old_parent_object_id) {
-        new_parent_node = FindParent(bookmark_model_, bookmark_record,
-            GetPendingNodeRoot());
+        new_parent_node = FindParent(bookmark_record);
       }
 
       if (new_parent_node) {
@@ -520,8 +711,12 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
         bookmark_model_->Move(node, new_parent_node, index);
       }
       UpdateNode(bookmark_model_, node, sync_record.get());
+      UpdateObjectIdIndex(node);
+      MarkDirty(node);
     } else if (node &&
                sync_record->action == jslib::SyncRecord::Action::A_DELETE) {
+      RemoveFromObjectIdIndex(node);
+      RemoveFromDirtyNodes(node);
       if (node->parent() == GetDeletedNodeRoot()) {
         // this is a deleted node so remove without firing events
         int index = GetDeletedNodeRoot()->GetIndexOf(node);
@@ -539,8 +734,7 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
       const bookmarks::BookmarkNode* parent_node = nullptr;
       if (!node) {
         // TODO(bridiver) make sure there isn't an existing record for objectId
-        parent_node =
-            FindParent(bookmark_model_, bookmark_record, GetPendingNodeRoot());
+        parent_node = FindParent(bookmark_record);
 
         const BookmarkNode* bookmark_bar = bookmark_model_->bookmark_bar_node();
         bool bookmark_bar_was_empty = bookmark_bar->empty();
@@ -562,6 +756,8 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
                                           true);
       }
       UpdateNode(bookmark_model_, node, sync_record.get(), GetPendingNodeRoot());
+      UpdateObjectIdIndex(node);
+      MarkDirty(node);
 
 #ifndef NDEBUG
       if (parent_node) {
@@ -697,6 +893,7 @@ BookmarkChangeProcessor::BookmarkNodeToSyncBookmark(
     record->objectId = tools::GenerateObjectId();
     record->action = jslib::SyncRecord::Action::A_CREATE;
     bookmark_model_->SetNodeMetaInfo(node, "object_id", record->objectId);
+    UpdateObjectIdIndex(node);
   } else if (node->HasAncestor(deleted_node)) {
     record->action = jslib::SyncRecord::Action::A_DELETE;
   } else {
@@ -730,7 +927,7 @@ void BookmarkChangeProcessor::GetAllSyncData(
   for (const auto& record : records) {
     auto resolved_record = std::make_unique<SyncRecordAndExisting>();
     resolved_record->first = jslib::SyncRecord::Clone(*record);
-    auto* node = FindByObjectId(bookmark_model_, record->objectId);
+    auto* node = FindByObjectId(record->objectId);
     if (node) {
       resolved_record->second = BookmarkNodeToSyncBookmark(node);
     }
@@ -775,9 +972,50 @@ bookmarks::BookmarkNode* BookmarkChangeProcessor::GetPendingNodeRoot() {
   return pending_node_root_;
 }
 
+void BookmarkChangeProcessor::SendUnsyncedNode(
+    const bookmarks::BookmarkNode* node,
+    base::Time now,
+    base::TimeDelta unsynced_send_interval,
+    std::vector<std::unique_ptr<jslib::SyncRecord>>* records) {
+  // only send unsynced records
+  if (!IsUnsynced(node))
+    return;
+
+  std::string last_send_time;
+  node->GetMetaInfo("last_send_time", &last_send_time);
+  if (!last_send_time.empty()) {
+    const base::Time send_time =
+        base::Time::FromJsTime(std::stod(last_send_time));
+    // don't send more often than unsynced_send_interval_
+    if (now - send_time < unsynced_send_interval) {
+      QueueRetry(node, send_time);
+      return;
+    }
+  }
+
+  {
+    ScopedPauseObserver pause(this);
+    bookmark_model_->SetNodeMetaInfo(node,
+        "last_send_time", std::to_string(now.ToJsTime()));
+  }
+  // stays unsynced until the record comes back from the server
+  QueueRetry(node, now);
+
+  auto record = BookmarkNodeToSyncBookmark(node);
+  if (record)
+    records->push_back(std::move(record));
+
+  if (records->size() == 1000) {
+    sync_client_->SendSyncRecords(
+        jslib_const::SyncRecordType_BOOKMARKS, *records);
+    records->clear();
+  }
+}
+
 void BookmarkChangeProcessor::SendUnsynced(
     base::TimeDelta unsynced_send_interval) {
   std::vector<std::unique_ptr<jslib::SyncRecord>> records;
+  const base::Time now = base::Time::Now();
 
   auto* deleted_node = GetDeletedNodeRoot();
   CHECK(deleted_node);
@@ -787,41 +1025,42 @@ void BookmarkChangeProcessor::SendUnsynced(
     deleted_node
   };
 
-  for (const auto* root_node : root_nodes) {
-    ui::TreeNodeIterator<const bookmarks::BookmarkNode>
-        iterator(root_node);
-    while (iterator.has_next()) {
-      const bookmarks::BookmarkNode* node = iterator.Next();
-
-      // only send unsynced records
-      if (!IsUnsynced(node))
-        continue;
-
-      std::string last_send_time;
-      node->GetMetaInfo("last_send_time", &last_send_time);
-      if (!last_send_time.empty() &&
-          // don't send more often than unsynced_send_interval_
-          (base::Time::Now() -
-              base::Time::FromJsTime(std::stod(last_send_time))) <
-          unsynced_send_interval)
-        continue;
-
-      {
-        ScopedPauseObserver pause(this);
-        bookmark_model_->SetNodeMetaInfo(node,
-            "last_send_time", std::to_string(base::Time::Now().ToJsTime()));
+  if (!dirty_nodes_valid_ || !observing_) {
+    InvalidateDirtyNodes();
+    dirty_nodes_valid_ = observing_;
+    for (const auto* root_node : root_nodes) {
+      ui::TreeNodeIterator<const bookmarks::BookmarkNode>
+          iterator(root_node);
+      while (iterator.has_next()) {
+        SendUnsyncedNode(
+            iterator.Next(), now, unsynced_send_interval, &records);
       }
-      auto record = BookmarkNodeToSyncBookmark(node);
-      if (record)
-        records.push_back(std::move(record));
-
-      if (records.size() == 1000) {
-        sync_client_->SendSyncRecords(
-            jslib_const::SyncRecordType_BOOKMARKS, records);
-        records.clear();
+    }
+  } else {
+    while (!retry_queue_.empty() &&
+           now - retry_queue_.begin()->first >= unsynced_send_interval) {
+      MarkDirty(retry_queue_.begin()->second);
+    }
+
+    std::set<const bookmarks::BookmarkNode*> dirty_nodes;
+    dirty_nodes.swap(dirty_nodes_);
+    while (!dirty_nodes.empty()) {
+      const bookmarks::BookmarkNode* node = *dirty_nodes.begin();
+      // send dirty parents first, a new folder gets the object_id which its
+      // children are sent with
+      while (dirty_nodes.count(node->parent()))
+        node = node->parent();
+      dirty_nodes.erase(node);
+
+      for (const auto* root_node : root_nodes) {
+        if (node != root_node && node->HasAncestor(root_node)) {
+          SendUnsyncedNode(node, now, unsynced_send_interval, &records);
+          break;
+        }
       }
     }
   }
+
   if (!records.empty()) {
     sync_client_->SendSyncRecords(
       jslib_const::SyncRecordType_BOOKMARKS, records);
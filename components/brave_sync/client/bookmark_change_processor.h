@@ -5,7 +5,12 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARKS_BOOKMARK_CHANGE_PROCESSOR_H_
 #define BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARKS_BOOKMARK_CHANGE_PROCESSOR_H_
 
+#include <map>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
@@ -18,11 +23,18 @@
 #include "components/bookmarks/browser/bookmark_node_data.h"
 
 FORWARD_DECLARE_TEST(BraveBookmarkChangeProcessorTest, IgnoreRapidCreateDelete);
+FORWARD_DECLARE_TEST(BraveBookmarkChangeProcessorTest,
+                     ObjectIdIndexFollowsModelChanges);
+FORWARD_DECLARE_TEST(BraveBookmarkChangeProcessorTest, ObjectIdIndexBenchmark);
+FORWARD_DECLARE_TEST(BraveBookmarkChangeProcessorTest,
+                     DirtyNodesFollowModelChanges);
 
 class BraveBookmarkChangeProcessorTest;
 
 namespace brave_sync {
 
+class ScopedPauseObserver;
+
 class BookmarkChangeProcessor : public ChangeProcessor,
                                        bookmarks::BookmarkModelObserver  {
  public:
@@ -45,8 +57,15 @@ class BookmarkChangeProcessor : public ChangeProcessor,
 
  private:
   friend class ::BraveBookmarkChangeProcessorTest;
+  friend class ScopedPauseObserver;
   FRIEND_TEST_ALL_PREFIXES(::BraveBookmarkChangeProcessorTest,
                                                        IgnoreRapidCreateDelete);
+  FRIEND_TEST_ALL_PREFIXES(::BraveBookmarkChangeProcessorTest,
+                           ObjectIdIndexFollowsModelChanges);
+  FRIEND_TEST_ALL_PREFIXES(::BraveBookmarkChangeProcessorTest,
+                           ObjectIdIndexBenchmark);
+  FRIEND_TEST_ALL_PREFIXES(::BraveBookmarkChangeProcessorTest,
+                           DirtyNodesFollowModelChanges);
 
   BookmarkChangeProcessor(Profile* profile,
                           BraveSyncClient* sync_client,
@@ -105,6 +124,40 @@ class BookmarkChangeProcessor : public ChangeProcessor,
       const bookmarks::BookmarkNode* created_folder_node,
       const std::string& created_folder_object_id);
 
+  const bookmarks::BookmarkNode* FindByObjectId(const std::string& object_id);
+  const bookmarks::BookmarkNode* FindParent(const jslib::Bookmark& bookmark);
+
+  // The object_id index is only used while observing the model, since that
+  // is how it learns about nodes removed by others. Changes made by this
+  // class with the observer paused update it explicitly.
+  void BuildObjectIdIndex();
+  void InvalidateObjectIdIndex();
+  // Indexes |node| under its current object_id.
+  void UpdateObjectIdIndex(const bookmarks::BookmarkNode* node);
+  // Index or unindex |node| and all of its descendants.
+  void AddToObjectIdIndex(const bookmarks::BookmarkNode* node);
+  void RemoveFromObjectIdIndex(const bookmarks::BookmarkNode* node);
+
+  // Sends |node| if it is unsynced and was not sent during the last
+  // |unsynced_send_interval|, otherwise queues it for a later retry.
+  void SendUnsyncedNode(
+      const bookmarks::BookmarkNode* node,
+      base::Time now,
+      base::TimeDelta unsynced_send_interval,
+      std::vector<std::unique_ptr<jslib::SyncRecord>>* records);
+
+  // Like the object_id index, the dirty nodes are only tracked while
+  // observing the model. Until then SendUnsynced walks the whole tree.
+  void InvalidateDirtyNodes();
+  // Makes |node| checked by the next SendUnsynced.
+  void MarkDirty(const bookmarks::BookmarkNode* node);
+  // Mark or forget |node| and all of its descendants.
+  void AddToDirtyNodes(const bookmarks::BookmarkNode* node);
+  void RemoveFromDirtyNodes(const bookmarks::BookmarkNode* node);
+  // Checks |node| again once |send_time| is |unsynced_send_interval| ago.
+  void QueueRetry(const bookmarks::BookmarkNode* node, base::Time send_time);
+  void DequeueRetry(const bookmarks::BookmarkNode* node);
+
   BraveSyncClient* sync_client_;  // not owned
   prefs::Prefs* sync_prefs_;  // not owned
   Profile* profile_; // not owned
@@ -113,6 +166,18 @@ class BookmarkChangeProcessor : public ChangeProcessor,
   bookmarks::BookmarkNode* deleted_node_root_;
   bookmarks::BookmarkNode* pending_node_root_;
 
+  bool observing_;
+  bool object_id_index_valid_;
+  std::unordered_map<std::string, const bookmarks::BookmarkNode*>
+      object_id_index_;
+
+  bool dirty_nodes_valid_;
+  std::set<const bookmarks::BookmarkNode*> dirty_nodes_;
+  // Unsynced nodes which were sent, ordered by their last send time.
+  std::set<std::pair<base::Time, const bookmarks::BookmarkNode*>>
+      retry_queue_;
+  std::map<const bookmarks::BookmarkNode*, base::Time> retry_times_;
+
   DISALLOW_COPY_AND_ASSIGN(BookmarkChangeProcessor);
 };
 
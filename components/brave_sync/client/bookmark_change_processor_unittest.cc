@@ -4,6 +4,7 @@
 
 #include "base/files/scoped_temp_dir.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "brave/components/brave_sync/client/bookmark_change_processor.h"
 #include "brave/components/brave_sync/client/brave_sync_client_impl.h"
 #include "brave/components/brave_sync/client/client_ext_impl_data.h"
@@ -43,7 +44,7 @@
 // BookmarkModelLoaded         | N/A
 // BookmarkModelBeingDeleted   | N/A
 // BookmarkNodeMoved           | +
-// BookmarkNodeAdded           | N/A
+// BookmarkNodeAdded           | +
 // OnWillRemoveBookmarks       | N/A
 // BookmarkNodeRemoved         | +
 // BookmarkAllUserNodesRemoved | N/A
@@ -1240,3 +1241,210 @@ TEST_F(BraveBookmarkChangeProcessorTest, IgnoreRapidCreateDelete) {
   EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _)).Times(0);
   change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
 }
+
+TEST_F(BraveBookmarkChangeProcessorTest, ObjectIdIndexFollowsModelChanges) {
+  change_processor()->Start();
+
+  const auto* node_a = model()->AddURL(model()->other_node(), 0,
+                                       base::ASCIIToUTF16("A.com - title"),
+                                       GURL("https://a.com/"));
+  model()->SetNodeMetaInfo(node_a, "object_id", "a");
+  EXPECT_EQ(change_processor()->FindByObjectId("a"), node_a);
+  EXPECT_TRUE(change_processor()->object_id_index_valid_);
+
+  // Nodes added and changed after the index was built
+  const auto* node_b = model()->AddURL(model()->other_node(), 1,
+                                       base::ASCIIToUTF16("B.com - title"),
+                                       GURL("https://b.com/"));
+  model()->SetNodeMetaInfo(node_b, "object_id", "b");
+  EXPECT_EQ(change_processor()->object_id_index_.count("b"), 1u);
+  EXPECT_EQ(change_processor()->FindByObjectId("b"), node_b);
+
+  model()->SetNodeMetaInfo(node_b, "object_id", "c");
+  EXPECT_EQ(change_processor()->FindByObjectId("c"), node_b);
+  EXPECT_EQ(change_processor()->FindByObjectId("b"), nullptr);
+
+  // Removed node is found by its clone in Deleted Bookmarks
+  model()->Remove(node_a);
+  const auto* deleted_a = change_processor()->FindByObjectId("a");
+  ASSERT_NE(deleted_a, nullptr);
+  EXPECT_EQ(deleted_a->parent(), GetDeletedNodeRoot());
+
+  // Nodes applied from sync
+  RecordsList records;
+  records.push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_CREATE,
+      "d",
+      "https://d.com/",
+      "D.com - title",
+      "1.1.1.1", ""));
+  change_processor()->ApplyChangesFromSyncModel(records);
+  const auto* node_d = change_processor()->FindByObjectId("d");
+  ASSERT_NE(node_d, nullptr);
+  EXPECT_EQ(node_d->url().spec(), "https://d.com/");
+
+  records.clear();
+  records.push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_DELETE,
+      "d",
+      "https://d.com/",
+      "D.com - title",
+      "1.1.1.1", ""));
+  change_processor()->ApplyChangesFromSyncModel(records);
+  EXPECT_EQ(change_processor()->object_id_index_.count("d"), 0u);
+  EXPECT_EQ(change_processor()->FindByObjectId("d"), nullptr);
+
+  // Without the observer lookups walk the tree
+  change_processor()->Stop();
+  EXPECT_FALSE(change_processor()->object_id_index_valid_);
+  EXPECT_EQ(change_processor()->FindByObjectId("c"), node_b);
+  EXPECT_FALSE(change_processor()->object_id_index_valid_);
+  EXPECT_EQ(change_processor()->FindByObjectId(""), nullptr);
+}
+
+TEST_F(BraveBookmarkChangeProcessorTest, DISABLED_ObjectIdIndexBenchmark) {
+  const int kBookmarks = 20000;
+  const int kUpdates = 5000;
+
+  for (int i = 0; i < kBookmarks; ++i) {
+    const auto* node = model()->AddURL(model()->other_node(), i,
+        base::ASCIIToUTF16("title"),
+        GURL("https://" + std::to_string(i) + ".com/"));
+    model()->SetNodeMetaInfo(node, "object_id", std::to_string(i));
+    model()->SetNodeMetaInfo(node, "order", "1.1.1." + std::to_string(i + 1));
+  }
+
+  // Tree walk, as used without the observer
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kUpdates; ++i) {
+    const int id = i * kBookmarks / kUpdates;
+    ASSERT_NE(change_processor()->FindByObjectId(std::to_string(id)), nullptr);
+  }
+  const base::TimeDelta walk_time = base::TimeTicks::Now() - start;
+
+  change_processor()->Start();
+
+  RecordsList records;
+  for (int i = 0; i < kUpdates; ++i) {
+    const int id = i * kBookmarks / kUpdates;
+    records.push_back(SimpleBookmarkSyncRecord(
+        jslib::SyncRecord::Action::A_UPDATE,
+        std::to_string(id),
+        "https://" + std::to_string(id) + ".com/",
+        "title - modified",
+        "1.1.1." + std::to_string(id + 1), ""));
+  }
+
+  start = base::TimeTicks::Now();
+  change_processor()->ApplyChangesFromSyncModel(records);
+  const base::TimeDelta apply_time = base::TimeTicks::Now() - start;
+
+  EXPECT_EQ(model()->other_node()->GetChild(0)->GetTitle(),
+            base::ASCIIToUTF16("title - modified"));
+
+  LOG(INFO) << kUpdates << " lookups in " << kBookmarks << " bookmarks: "
+            << "tree walk " << walk_time.InMilliseconds() << " ms, "
+            << "applying the updates with the index "
+            << apply_time.InMilliseconds() << " ms";
+}
+
+TEST_F(BraveBookmarkChangeProcessorTest, DirtyNodesFollowModelChanges) {
+  change_processor()->Start();
+
+  const BookmarkNode* folder1;
+  const BookmarkNode* node_a;
+  const BookmarkNode* node_b;
+  const BookmarkNode* node_c;
+  AddSimpleHierarchy(&folder1, &node_a, &node_b, &node_c);
+
+  // First send walks the tree and queues the sent nodes for a retry
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS",
+      RecordsNumber(4))).Times(1);
+  EXPECT_CALL(*sync_client(), ClearOrderMap()).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+  EXPECT_TRUE(change_processor()->dirty_nodes_valid_);
+  EXPECT_TRUE(change_processor()->dirty_nodes_.empty());
+  EXPECT_EQ(change_processor()->retry_queue_.size(), 4u);
+
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _)).Times(0);
+  EXPECT_CALL(*sync_client(), ClearOrderMap()).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+
+  // Changed node is sent again without waiting for the retry
+  model()->SetTitle(node_b, base::ASCIIToUTF16("B.com - title - modified"));
+  EXPECT_EQ(change_processor()->dirty_nodes_.count(node_b), 1u);
+  EXPECT_EQ(change_processor()->retry_times_.count(node_b), 0u);
+
+  using brave_sync::jslib::SyncRecord;
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS",
+      RecordsNumber(1))).Times(1);
+  EXPECT_CALL(*sync_client(), ClearOrderMap()).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+
+  // Removed node is replaced by its clone in Deleted Bookmarks
+  model()->Remove(node_c);
+  EXPECT_EQ(change_processor()->dirty_nodes_.size(), 1u);
+  EXPECT_EQ(change_processor()->retry_queue_.size(), 3u);
+
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS",
+      ContainsRecord(SyncRecord::Action::A_DELETE, "https://c.com/")))
+      .Times(1);
+  EXPECT_CALL(*sync_client(), ClearOrderMap()).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+
+  // Node confirmed by sync leaves the retry queue
+  std::string folder1_object_id;
+  folder1->GetMetaInfo("object_id", &folder1_object_id);
+  std::string node_a_object_id;
+  node_a->GetMetaInfo("object_id", &node_a_object_id);
+  RecordsList records;
+  records.push_back(SimpleBookmarkSyncRecord(
+      SyncRecord::Action::A_UPDATE,
+      node_a_object_id,
+      "https://a.com/",
+      "A.com - title",
+      "1.1.1.1", folder1_object_id));
+  change_processor()->ApplyChangesFromSyncModel(records);
+  EXPECT_EQ(change_processor()->retry_times_.count(node_a), 0u);
+
+  // Once the interval passes, the rest are sent again
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS",
+      RecordsNumber(3))).Times(1);
+  EXPECT_CALL(*sync_client(), ClearOrderMap()).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(0));
+  EXPECT_EQ(change_processor()->retry_queue_.size(), 3u);
+
+  change_processor()->Stop();
+  EXPECT_FALSE(change_processor()->dirty_nodes_valid_);
+  EXPECT_TRUE(change_processor()->retry_queue_.empty());
+}
+
+TEST_F(BraveBookmarkChangeProcessorTest, CreatedFromSyncBetweenOrderedNodes) {
+  change_processor()->Start();
+
+  // Local node without order is skipped when looking for the index
+  model()->AddURL(model()->other_node(), 0,
+                  base::ASCIIToUTF16("Local - title"),
+                  GURL("https://local.com/"));
+
+  const std::vector<std::string> orders = {
+      "1.1.1.3", "1.1.1.1", "1.1.1.10", "1.1.1.2"};
+  for (const auto& order : orders) {
+    RecordsList records;
+    records.push_back(SimpleBookmarkSyncRecord(
+        jslib::SyncRecord::Action::A_CREATE,
+        "",
+        "https://" + order + ".com/",
+        order,
+        order, ""));
+    change_processor()->ApplyChangesFromSyncModel(records);
+  }
+
+  const auto* other_node = model()->other_node();
+  ASSERT_EQ(other_node->child_count(), 5);
+  EXPECT_EQ(other_node->GetChild(0)->url().spec(), "https://local.com/");
+  EXPECT_EQ(other_node->GetChild(1)->url().spec(), "https://1.1.1.1.com/");
+  EXPECT_EQ(other_node->GetChild(2)->url().spec(), "https://1.1.1.2.com/");
+  EXPECT_EQ(other_node->GetChild(3)->url().spec(), "https://1.1.1.3.com/");
+  EXPECT_EQ(other_node->GetChild(4)->url().spec(), "https://1.1.1.10.com/");
+}
@@ -4,6 +4,9 @@
 
 #include "brave/components/services/bat_ledger/bat_ledger_client_mojo_proxy.h"
 
+#include <string>
+#include <vector>
+
 #include "base/logging.h"
 #include "mojo/public/cpp/bindings/map.h"
 
@@ -19,6 +22,14 @@ ledger::Result ToLedgerResult(int32_t result) {
   return (ledger::Result)result;
 }
 
+std::vector<uint8_t> ToMojomBytes(const std::string& data) {
+  return std::vector<uint8_t>(data.begin(), data.end());
+}
+
+std::string ToLedgerBytes(const std::vector<uint8_t>& data) {
+  return std::string(data.begin(), data.end());
+}
+
 int32_t ToMojomPublisherCategory(ledger::PUBLISHER_CATEGORY category) {
   return (int32_t)category;
 }
@@ -27,6 +38,20 @@ int32_t ToMojomMethod(ledger::URL_METHOD method) {
   return (int32_t)method;
 }
 
+std::unique_ptr<ledger::PublisherInfo> ToLedgerPublisherInfo(
+    const base::Optional<ledger::PublisherInfo>& info) {
+  if (!info)
+    return nullptr;
+  return std::make_unique<ledger::PublisherInfo>(info.value());
+}
+
+base::Optional<ledger::PublisherInfo> ToMojomPublisherInfo(
+    const ledger::PublisherInfo* info) {
+  if (!info)
+    return base::nullopt;
+  return *info;
+}
+
 class LogStreamImpl : public ledger::LogStream {
  public:
   LogStreamImpl(const char* file,
@@ -168,8 +193,8 @@ void BatLedgerClientMojoProxy::OnGrantFinish(ledger::Result result,
 }
 
 void BatLedgerClientMojoProxy::OnLoadLedgerState(ledger::LedgerCallbackHandler* handler,
-    int32_t result, const std::string& data) {
-  handler->OnLedgerStateLoaded(ToLedgerResult(result), data);
+    int32_t result, const std::vector<uint8_t>& data) {
+  handler->OnLedgerStateLoaded(ToLedgerResult(result), ToLedgerBytes(data));
 }
 
 void BatLedgerClientMojoProxy::LoadLedgerState(
@@ -186,8 +211,8 @@ void BatLedgerClientMojoProxy::LoadLedgerState(
 
 void BatLedgerClientMojoProxy::OnLoadPublisherState(
     ledger::LedgerCallbackHandler* handler,
-    int32_t result, const std::string& data) {
-  handler->OnPublisherStateLoaded(ToLedgerResult(result), data);
+    int32_t result, const std::vector<uint8_t>& data) {
+  handler->OnPublisherStateLoaded(ToLedgerResult(result), ToLedgerBytes(data));
 }
 
 void BatLedgerClientMojoProxy::LoadPublisherState(
@@ -204,8 +229,8 @@ void BatLedgerClientMojoProxy::LoadPublisherState(
 
 void BatLedgerClientMojoProxy::OnLoadPublisherList(
     ledger::LedgerCallbackHandler* handler,
-    int32_t result, const std::string& data) {
-  handler->OnPublisherListLoaded(ToLedgerResult(result), data);
+    int32_t result, const std::vector<uint8_t>& data) {
+  handler->OnPublisherListLoaded(ToLedgerResult(result), ToLedgerBytes(data));
 }
 
 void BatLedgerClientMojoProxy::LoadPublisherList(
@@ -233,7 +258,7 @@ void BatLedgerClientMojoProxy::SaveLedgerState(
     return;
   }
 
-  bat_ledger_client_->SaveLedgerState(ledger_state,
+  bat_ledger_client_->SaveLedgerState(ToMojomBytes(ledger_state),
       base::BindOnce(&BatLedgerClientMojoProxy::OnSaveLedgerState,
         AsWeakPtr(), base::Unretained(handler)));
 }
@@ -252,7 +277,7 @@ void BatLedgerClientMojoProxy::SavePublisherState(
     return;
   }
 
-  bat_ledger_client_->SavePublisherState(publisher_state,
+  bat_ledger_client_->SavePublisherState(ToMojomBytes(publisher_state),
       base::BindOnce(&BatLedgerClientMojoProxy::OnSavePublisherState,
         AsWeakPtr(), base::Unretained(handler)));
 }
@@ -271,19 +296,15 @@ void BatLedgerClientMojoProxy::SavePublishersList(
     return;
   }
 
-  bat_ledger_client_->SavePublishersList(publishers_list,
+  bat_ledger_client_->SavePublishersList(ToMojomBytes(publishers_list),
       base::BindOnce(&BatLedgerClientMojoProxy::OnSavePublishersList,
         AsWeakPtr(), base::Unretained(handler)));
 }
 
 void OnSavePublisherInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-  callback(ToLedgerResult(result), std::move(info));
+    int32_t result,
+    const base::Optional<ledger::PublisherInfo>& publisher_info) {
+  callback(ToLedgerResult(result), ToLedgerPublisherInfo(publisher_info));
 }
 
 void BatLedgerClientMojoProxy::SavePublisherInfo(
@@ -295,19 +316,33 @@ void BatLedgerClientMojoProxy::SavePublisherInfo(
     return;
   }
 
-  std::string json_info = publisher_info ? publisher_info->ToJson() : "";
-  bat_ledger_client_->SavePublisherInfo(json_info,
+  bat_ledger_client_->SavePublisherInfo(
+      ToMojomPublisherInfo(publisher_info.get()),
       base::BindOnce(&OnSavePublisherInfo, std::move(callback)));
 }
 
-void OnLoadPublisherInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
+void OnSavePublisherInfoList(
+    const ledger::SavePublisherInfoListCallback& callback,
+    int32_t result) {
+  callback(ToLedgerResult(result));
+}
+
+void BatLedgerClientMojoProxy::SavePublisherInfoList(
+    const ledger::PublisherInfoList& list,
+    ledger::SavePublisherInfoListCallback callback) {
+  if (!Connected()) {
+    callback(ledger::Result::LEDGER_ERROR);
+    return;
   }
-  callback(ToLedgerResult(result), std::move(info));
+
+  bat_ledger_client_->SavePublisherInfoList(list,
+      base::BindOnce(&OnSavePublisherInfoList, std::move(callback)));
+}
+
+void OnLoadPublisherInfo(const ledger::PublisherInfoCallback& callback,
+    int32_t result,
+    const base::Optional<ledger::PublisherInfo>& publisher_info) {
+  callback(ToLedgerResult(result), ToLedgerPublisherInfo(publisher_info));
 }
 
 void BatLedgerClientMojoProxy::LoadPublisherInfo(
@@ -319,22 +354,14 @@ void BatLedgerClientMojoProxy::LoadPublisherInfo(
     return;
   }
 
-  bat_ledger_client_->LoadPublisherInfo(filter.ToJson(),
+  bat_ledger_client_->LoadPublisherInfo(filter,
       base::BindOnce(&OnLoadPublisherInfo, std::move(callback)));
 }
 
 void OnLoadPublisherInfoList(const ledger::PublisherInfoListCallback& callback,
-    const std::vector<std::string>& publisher_info_list,
+    const ledger::PublisherInfoList& publisher_info_list,
     uint32_t next_record) {
-  ledger::PublisherInfoList list;
-
-  for (const auto& publisher_info : publisher_info_list) {
-    ledger::PublisherInfo info;
-    info.loadFromJson(publisher_info);
-    list.push_back(info);
-  }
-
-  callback(list, next_record);
+  callback(publisher_info_list, next_record);
 }
 
 void BatLedgerClientMojoProxy::LoadPublisherInfoList(
@@ -347,18 +374,14 @@ void BatLedgerClientMojoProxy::LoadPublisherInfoList(
     return;
   }
 
-  bat_ledger_client_->LoadPublisherInfoList(start, limit, filter.ToJson(),
+  bat_ledger_client_->LoadPublisherInfoList(start, limit, filter,
       base::BindOnce(&OnLoadPublisherInfoList, std::move(callback)));
 }
 
 void OnLoadMediaPublisherInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-  callback(ToLedgerResult(result), std::move(info));
+    int32_t result,
+    const base::Optional<ledger::PublisherInfo>& publisher_info) {
+  callback(ToLedgerResult(result), ToLedgerPublisherInfo(publisher_info));
 }
 
 void BatLedgerClientMojoProxy::LoadMediaPublisherInfo(
@@ -399,9 +422,8 @@ void BatLedgerClientMojoProxy::OnPublisherActivity(ledger::Result result,
     return;
   }
 
-  std::string json_info = info ? info->ToJson() : "";
   bat_ledger_client_->OnPublisherActivity(ToMojomResult(result),
-      json_info, windowId);
+      ToMojomPublisherInfo(info.get()), windowId);
 }
 
 void OnFetchFavIcon(const ledger::FetchIconCallback& callback,
@@ -422,17 +444,9 @@ void BatLedgerClientMojoProxy::FetchFavIcon(const std::string& url,
 }
 
 void OnGetRecurringDonations(const ledger::PublisherInfoListCallback& callback,
-    const std::vector<std::string>& publisher_info_list,
+    const ledger::PublisherInfoList& publisher_info_list,
     uint32_t next_record) {
-  ledger::PublisherInfoList list;
-
-  for (const auto& publisher_info : publisher_info_list) {
-    ledger::PublisherInfo info;
-    info.loadFromJson(publisher_info);
-    list.push_back(info);
-  }
-
-  callback(list, next_record);
+  callback(publisher_info_list, next_record);
 }
 
 void BatLedgerClientMojoProxy::GetRecurringDonations(
@@ -6,6 +6,8 @@
 #define BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_BAT_LEDGER_CLIENT_MOJO_PROXY_H_
 
 #include <map>
+#include <string>
+#include <vector>
 
 #include "base/memory/weak_ptr.h"
 #include "bat/ledger/ledger_client.h"
@@ -47,6 +49,9 @@ class BatLedgerClientMojoProxy : public ledger::LedgerClient,
 
   void SavePublisherInfo(std::unique_ptr<ledger::PublisherInfo> publisher_info,
                          ledger::PublisherInfoCallback callback) override;
+  void SavePublisherInfoList(
+      const ledger::PublisherInfoList& list,
+      ledger::SavePublisherInfoListCallback callback) override;
   void LoadPublisherInfo(ledger::PublisherInfoFilter filter,
                          ledger::PublisherInfoCallback callback) override;
   void LoadPublisherInfoList(
@@ -105,11 +110,11 @@ class BatLedgerClientMojoProxy : public ledger::LedgerClient,
   mojom::BatLedgerClientAssociatedPtr bat_ledger_client_;
 
   void OnLoadLedgerState(ledger::LedgerCallbackHandler* handler,
-      int32_t result, const std::string& data);
+      int32_t result, const std::vector<uint8_t>& data);
   void OnLoadPublisherState(ledger::LedgerCallbackHandler* handler,
-      int32_t result, const std::string& data);
+      int32_t result, const std::vector<uint8_t>& data);
   void OnLoadPublisherList(ledger::LedgerCallbackHandler* handler,
-      int32_t result, const std::string& data);
+      int32_t result, const std::vector<uint8_t>& data);
   void OnSaveLedgerState(ledger::LedgerCallbackHandler* handler,
       int32_t result);
   void OnSavePublisherState(ledger::LedgerCallbackHandler* handler,
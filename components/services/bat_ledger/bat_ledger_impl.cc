@@ -91,57 +91,14 @@ void BatLedgerImpl::GetReconcileStamp(GetReconcileStampCallback callback) {
   std::move(callback).Run(ledger_->GetReconcileStamp());
 }
 
-void BatLedgerImpl::OnLoad(const std::string& visit_data,
-    uint64_t current_time) {
-  ledger::VisitData visitData;
-  if (visitData.loadFromJson(visit_data))
-    ledger_->OnLoad(visitData, current_time);
-}
-
-void BatLedgerImpl::OnUnload(uint32_t tab_id, uint64_t current_time) {
-  ledger_->OnUnload(tab_id, current_time);
-}
-
-void BatLedgerImpl::OnShow(uint32_t tab_id, uint64_t current_time) {
-  ledger_->OnShow(tab_id, current_time);
-}
-
-void BatLedgerImpl::OnHide(uint32_t tab_id, uint64_t current_time) {
-  ledger_->OnHide(tab_id, current_time);
-}
-
-void BatLedgerImpl::OnForeground(uint32_t tab_id, uint64_t current_time) {
-  ledger_->OnForeground(tab_id, current_time);
-}
-
-void BatLedgerImpl::OnBackground(uint32_t tab_id, uint64_t current_time) {
-  ledger_->OnBackground(tab_id, current_time);
-}
-
-void BatLedgerImpl::OnMediaStart(uint32_t tab_id, uint64_t current_time) {
-  ledger_->OnMediaStart(tab_id, current_time);
-}
-
-void BatLedgerImpl::OnMediaStop(uint32_t tab_id, uint64_t current_time) {
-  ledger_->OnMediaStop(tab_id, current_time);
+void BatLedgerImpl::OnTabEvents(const ledger::TabEventList& events) {
+  ledger_->OnTabEvents(events);
 }
 
 void BatLedgerImpl::OnPostData(const std::string& url,
     const std::string& first_party_url, const std::string& referrer,
-    const std::string& post_data, const std::string& visit_data) {
-  ledger::VisitData visitData;
-  if (visitData.loadFromJson(visit_data))
-    ledger_->OnPostData(url, first_party_url, referrer, post_data, visitData);
-}
-
-void BatLedgerImpl::OnXHRLoad(uint32_t tab_id, const std::string& url,
-    const base::flat_map<std::string, std::string>& parts,
-    const std::string& first_party_url, const std::string& referrer,
-    const std::string& visit_data) {
-  ledger::VisitData visitData;
-  if (visitData.loadFromJson(visit_data))
-    ledger_->OnXHRLoad(tab_id, url, mojo::FlatMapToMap(parts),
-        first_party_url, referrer, visitData);
+    const std::string& post_data, const ledger::VisitData& visit_data) {
+  ledger_->OnPostData(url, first_party_url, referrer, post_data, visit_data);
 }
 
 void BatLedgerImpl::SetPublisherExclude(const std::string& publisher_key,
@@ -272,10 +229,8 @@ void BatLedgerImpl::IsWalletCreated(IsWalletCreatedCallback callback) {
 }
 
 void BatLedgerImpl::GetPublisherActivityFromUrl(uint64_t window_id,
-    const std::string& visit_data) {
-  ledger::VisitData visitData;
-  if (visitData.loadFromJson(visit_data))
-    ledger_->GetPublisherActivityFromUrl(window_id, visitData);
+    const ledger::VisitData& visit_data) {
+  ledger_->GetPublisherActivityFromUrl(window_id, visit_data);
 }
 
 // static
@@ -302,25 +257,18 @@ void BatLedgerImpl::OnGetPublisherInfoList(
     CallbackHolder<GetPublisherInfoListCallback>* holder,
     const ledger::PublisherInfoList& list,
     uint32_t next_record) {
-  std::vector<std::string> publisher_info_list;
-  for (const auto& info : list) {
-    publisher_info_list.push_back(info.ToJson());
-  }
-
   if (holder->is_valid())
-    std::move(holder->get()).Run(publisher_info_list, next_record);
+    std::move(holder->get()).Run(list, next_record);
   delete holder;
 }
 
 void BatLedgerImpl::GetPublisherInfoList(uint32_t start, uint32_t limit,
-    const std::string& filter,
+    const ledger::PublisherInfoFilter& filter,
     GetPublisherInfoListCallback callback) {
   // delete in OnGetPublisherInfoList
   auto* holder = new CallbackHolder<GetPublisherInfoListCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger::PublisherInfoFilter publisher_info_filter;
-  publisher_info_filter.loadFromJson(filter);
-  ledger_->GetPublisherInfoList(start, limit, publisher_info_filter,
+  ledger_->GetPublisherInfoList(start, limit, filter,
       std::bind(BatLedgerImpl::OnGetPublisherInfoList, holder, _1, _2));
 }
 
@@ -329,11 +277,10 @@ void BatLedgerImpl::GetContributionAmount(
   std::move(callback).Run(ledger_->GetContributionAmount());
 }
 
-void BatLedgerImpl::DoDirectDonation(const std::string& publisher_info,
+void BatLedgerImpl::DoDirectDonation(
+    const ledger::PublisherInfo& publisher_info,
     int32_t amount, const std::string& currency) {
-  ledger::PublisherInfo info;
-  if (info.loadFromJson(publisher_info))
-    ledger_->DoDirectDonation(info, amount, currency);
+  ledger_->DoDirectDonation(publisher_info, amount, currency);
 }
 
 void BatLedgerImpl::RemoveRecurring(const std::string& publisher_key) {
@@ -40,22 +40,12 @@ class BatLedgerImpl : public mojom::BatLedger,
     void GetAutoContribute(GetAutoContributeCallback callback) override;
     void GetReconcileStamp(GetReconcileStampCallback callback) override;
 
-    void OnLoad(const std::string& visit_data, uint64_t current_time) override;
-    void OnUnload(uint32_t tab_id, uint64_t current_time) override;
-    void OnShow(uint32_t tab_id, uint64_t current_time) override;
-    void OnHide(uint32_t tab_id, uint64_t current_time) override;
-    void OnForeground(uint32_t tab_id, uint64_t current_time) override;
-    void OnBackground(uint32_t tab_id, uint64_t current_time) override;
-    void OnMediaStart(uint32_t tab_id, uint64_t current_time) override;
-    void OnMediaStop(uint32_t tab_id, uint64_t current_time) override;
+    void OnTabEvents(const ledger::TabEventList& events) override;
 
     void OnPostData(const std::string& url,
         const std::string& first_party_url, const std::string& referrer,
-        const std::string& post_data, const std::string& visit_data) override;
-    void OnXHRLoad(uint32_t tab_id, const std::string& url,
-        const base::flat_map<std::string, std::string>& parts,
-        const std::string& first_party_url, const std::string& referrer,
-        const std::string& visit_data) override;
+        const std::string& post_data,
+        const ledger::VisitData& visit_data) override;
 
     void SetPublisherExclude(const std::string& publisher_key,
         int32_t exclude) override;
@@ -100,18 +90,18 @@ class BatLedgerImpl : public mojom::BatLedger,
     void IsWalletCreated(IsWalletCreatedCallback callback) override;
 
     void GetPublisherActivityFromUrl(uint64_t window_id,
-        const std::string& visit_data) override;
+        const ledger::VisitData& visit_data) override;
 
     void GetContributionAmount(
       GetContributionAmountCallback callback) override;
     void GetPublisherBanner(const std::string& publisher_id,
         GetPublisherBannerCallback callback) override;
     void GetPublisherInfoList(uint32_t start, uint32_t limit,
-        const std::string& filter,
+        const ledger::PublisherInfoFilter& filter,
         GetPublisherInfoListCallback callback) override;
 
-    void DoDirectDonation(const std::string& publisher_info, int32_t amount,
-        const std::string& currency) override;
+    void DoDirectDonation(const ledger::PublisherInfo& publisher_info,
+        int32_t amount, const std::string& currency) override;
 
     void RemoveRecurring(const std::string& publisher_key) override;
     void SetPublisherPanelExclude(const std::string& publisher_key,
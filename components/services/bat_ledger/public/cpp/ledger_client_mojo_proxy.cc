@@ -4,6 +4,9 @@
 
 #include "brave/components/services/bat_ledger/public/cpp/ledger_client_mojo_proxy.h"
 
+#include <string>
+#include <vector>
+
 #include "base/logging.h"
 #include "mojo/public/cpp/bindings/map.h"
 
@@ -21,6 +24,14 @@ ledger::Result ToLedgerResult(int32_t result) {
   return (ledger::Result)result;
 }
 
+std::vector<uint8_t> ToMojomBytes(const std::string& data) {
+  return std::vector<uint8_t>(data.begin(), data.end());
+}
+
+std::string ToLedgerBytes(const std::vector<uint8_t>& data) {
+  return std::string(data.begin(), data.end());
+}
+
 ledger::PUBLISHER_CATEGORY ToLedgerPublisherCategory(int32_t category) {
   return (ledger::PUBLISHER_CATEGORY)category;
 }
@@ -35,6 +46,20 @@ ledger::URL_METHOD ToLedgerURLMethod(int32_t method) {
   return (ledger::URL_METHOD)method;
 }
 
+std::unique_ptr<ledger::PublisherInfo> ToLedgerPublisherInfo(
+    const base::Optional<ledger::PublisherInfo>& info) {
+  if (!info)
+    return nullptr;
+  return std::make_unique<ledger::PublisherInfo>(info.value());
+}
+
+base::Optional<ledger::PublisherInfo> ToMojomPublisherInfo(
+    const ledger::PublisherInfo* info) {
+  if (!info)
+    return base::nullopt;
+  return *info;
+}
+
 } // anonymous namespace
 
 LedgerClientMojoProxy::LedgerClientMojoProxy(
@@ -56,7 +81,7 @@ void LedgerClientMojoProxy::CallbackHolder<
   LedgerClientMojoProxy::LoadLedgerStateCallback>::OnLedgerStateLoaded(
     ledger::Result result, const std::string& data) {
   if (is_valid())
-    std::move(callback_).Run(ToMojomResult(result), data);
+    std::move(callback_).Run(ToMojomResult(result), ToMojomBytes(data));
   delete this;
 }
 
@@ -103,7 +128,7 @@ void LedgerClientMojoProxy::CallbackHolder<
   LedgerClientMojoProxy::LoadPublisherStateCallback>::OnPublisherStateLoaded(
     ledger::Result result, const std::string& data) {
   if (is_valid())
-    std::move(callback_).Run(ToMojomResult(result), data);
+    std::move(callback_).Run(ToMojomResult(result), ToMojomBytes(data));
   delete this;
 }
 
@@ -125,15 +150,16 @@ void LedgerClientMojoProxy::CallbackHolder<
   LedgerClientMojoProxy::LoadPublisherListCallback>::OnPublisherListLoaded(
     ledger::Result result, const std::string& data) {
   if (is_valid())
-    std::move(callback_).Run(ToMojomResult(result), data);
+    std::move(callback_).Run(ToMojomResult(result), ToMojomBytes(data));
   delete this;
 }
 
 void LedgerClientMojoProxy::SaveLedgerState(
-    const std::string& ledger_state, SaveLedgerStateCallback callback) {
+    const std::vector<uint8_t>& ledger_state,
+    SaveLedgerStateCallback callback) {
   auto* holder = new CallbackHolder<SaveLedgerStateCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger_client_->SaveLedgerState(ledger_state, holder);
+  ledger_client_->SaveLedgerState(ToLedgerBytes(ledger_state), holder);
 }
 
 template <typename Callback>
@@ -152,10 +178,11 @@ void LedgerClientMojoProxy::CallbackHolder<
 }
 
 void LedgerClientMojoProxy::SavePublisherState(
-    const std::string& publisher_state, SavePublisherStateCallback callback) {
+    const std::vector<uint8_t>& publisher_state,
+    SavePublisherStateCallback callback) {
   auto* holder = new CallbackHolder<SavePublisherStateCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger_client_->SavePublisherState(publisher_state, holder);
+  ledger_client_->SavePublisherState(ToLedgerBytes(publisher_state), holder);
 }
 
 template <typename Callback>
@@ -174,10 +201,11 @@ void LedgerClientMojoProxy::CallbackHolder<
 }
 
 void LedgerClientMojoProxy::SavePublishersList(
-    const std::string& publishers_list, SavePublishersListCallback callback) {
+    const std::vector<uint8_t>& publishers_list,
+    SavePublishersListCallback callback) {
   auto* holder = new CallbackHolder<SavePublishersListCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger_client_->SavePublishersList(publishers_list, holder);
+  ledger_client_->SavePublishersList(ToLedgerBytes(publishers_list), holder);
 }
 
 template <typename Callback>
@@ -233,48 +261,61 @@ void LedgerClientMojoProxy::OnSavePublisherInfo(
     CallbackHolder<SavePublisherInfoCallback>* holder,
     ledger::Result result,
     std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
-  if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run(ToMojomResult(result),
+        ToMojomPublisherInfo(info.get()));
+  }
   delete holder;
 }
 
 void LedgerClientMojoProxy::SavePublisherInfo(
-    const std::string& publisher_info,
+    const base::Optional<ledger::PublisherInfo>& publisher_info,
     SavePublisherInfoCallback callback) {
   // deleted in OnSavePublisherInfo
   auto* holder = new CallbackHolder<SavePublisherInfoCallback>(
       AsWeakPtr(), std::move(callback));
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-
-  ledger_client_->SavePublisherInfo(std::move(info),
+  ledger_client_->SavePublisherInfo(ToLedgerPublisherInfo(publisher_info),
       std::bind(LedgerClientMojoProxy::OnSavePublisherInfo, holder, _1, _2));
 }
 
+// static
+void LedgerClientMojoProxy::OnSavePublisherInfoList(
+    CallbackHolder<SavePublisherInfoListCallback>* holder,
+    ledger::Result result) {
+  if (holder->is_valid())
+    std::move(holder->get()).Run(ToMojomResult(result));
+  delete holder;
+}
+
+void LedgerClientMojoProxy::SavePublisherInfoList(
+    const ledger::PublisherInfoList& publisher_info_list,
+    SavePublisherInfoListCallback callback) {
+  // deleted in OnSavePublisherInfoList
+  auto* holder = new CallbackHolder<SavePublisherInfoListCallback>(
+      AsWeakPtr(), std::move(callback));
+  ledger_client_->SavePublisherInfoList(publisher_info_list,
+      std::bind(LedgerClientMojoProxy::OnSavePublisherInfoList, holder, _1));
+}
+
 // static
 void LedgerClientMojoProxy::OnLoadPublisherInfo(
     CallbackHolder<LoadPublisherInfoCallback>* holder,
     ledger::Result result,
     std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
-  if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run(ToMojomResult(result),
+        ToMojomPublisherInfo(info.get()));
+  }
   delete holder;
 }
 
 void LedgerClientMojoProxy::LoadPublisherInfo(
-    const std::string& filter,
+    const ledger::PublisherInfoFilter& filter,
     LoadPublisherInfoCallback callback) {
   // deleted in OnLoadPublisherInfo
   auto* holder = new CallbackHolder<LoadPublisherInfoCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger::PublisherInfoFilter publisher_info_filter;
-  publisher_info_filter.loadFromJson(filter);
-  ledger_client_->LoadPublisherInfo(publisher_info_filter,
+  ledger_client_->LoadPublisherInfo(filter,
       std::bind(LedgerClientMojoProxy::OnLoadPublisherInfo, holder, _1, _2));
 }
 
@@ -283,26 +324,19 @@ void LedgerClientMojoProxy::OnLoadPublisherInfoList(
     CallbackHolder<LoadPublisherInfoListCallback>* holder,
     const ledger::PublisherInfoList& list,
     uint32_t next_record) {
-  std::vector<std::string> publisher_info_list;
-  for (const auto& info : list) {
-    publisher_info_list.push_back(info.ToJson());
-  }
-
   if (holder->is_valid())
-    std::move(holder->get()).Run(publisher_info_list, next_record);
+    std::move(holder->get()).Run(list, next_record);
   delete holder;
 }
 
 void LedgerClientMojoProxy::LoadPublisherInfoList(uint32_t start,
     uint32_t limit,
-    const std::string& filter,
+    const ledger::PublisherInfoFilter& filter,
     LoadPublisherInfoListCallback callback) {
   // deleted in OnLoadPublisherInfoList
   auto* holder = new CallbackHolder<LoadPublisherInfoListCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger::PublisherInfoFilter publisher_info_filter;
-  publisher_info_filter.loadFromJson(filter);
-  ledger_client_->LoadPublisherInfoList(start, limit, publisher_info_filter,
+  ledger_client_->LoadPublisherInfoList(start, limit, filter,
       std::bind(LedgerClientMojoProxy::OnLoadPublisherInfoList,
         holder, _1, _2));
 }
@@ -312,9 +346,10 @@ void LedgerClientMojoProxy::OnLoadMediaPublisherInfo(
     CallbackHolder<LoadMediaPublisherInfoCallback>* holder,
     ledger::Result result,
     std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
-  if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run(ToMojomResult(result),
+        ToMojomPublisherInfo(info.get()));
+  }
   delete holder;
 }
 
@@ -341,14 +376,9 @@ void LedgerClientMojoProxy::OnExcludedSitesChanged(
 }
 
 void LedgerClientMojoProxy::OnPublisherActivity(int32_t result,
-    const std::string& info, uint64_t window_id) {
-  std::unique_ptr<ledger::PublisherInfo> publisher_info;
-  if (!info.empty()) {
-    publisher_info.reset(new ledger::PublisherInfo());
-    publisher_info->loadFromJson(info);
-  }
+    const base::Optional<ledger::PublisherInfo>& info, uint64_t window_id) {
   ledger_client_->OnPublisherActivity(ToLedgerResult(result),
-      std::move(publisher_info), window_id);
+      ToLedgerPublisherInfo(info), window_id);
 }
 
 // static
@@ -374,13 +404,8 @@ void LedgerClientMojoProxy::OnGetRecurringDonations(
     CallbackHolder<GetRecurringDonationsCallback>* holder,
     const ledger::PublisherInfoList& publisher_info_list,
     uint32_t next_record) {
-  std::vector<std::string> list;
-  for (const auto& publisher_info : publisher_info_list) {
-    list.push_back(publisher_info.ToJson());
-  }
-
   if (holder->is_valid())
-    std::move(holder->get()).Run(list, next_record);
+    std::move(holder->get()).Run(publisher_info_list, next_record);
   delete holder;
 }
 
@@ -6,6 +6,8 @@
 #define BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_PUBLIC_CPP_LEDGER_CLIENT_MOJO_PROXY_H_
 
 #include <map>
+#include <string>
+#include <vector>
 
 #include "base/memory/weak_ptr.h"
 #include "bat/ledger/ledger_client.h"
@@ -35,19 +37,23 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
 
   void LoadPublisherState(LoadPublisherStateCallback callback) override;
   void LoadPublisherList(LoadPublisherListCallback callback) override;
-  void SaveLedgerState(const std::string& ledger_state,
+  void SaveLedgerState(const std::vector<uint8_t>& ledger_state,
       SaveLedgerStateCallback callback) override;
-  void SavePublisherState(const std::string& publisher_state,
+  void SavePublisherState(const std::vector<uint8_t>& publisher_state,
       SavePublisherStateCallback callback) override;
-  void SavePublishersList(const std::string& publishers_list,
+  void SavePublishersList(const std::vector<uint8_t>& publishers_list,
       SavePublishersListCallback callback) override;
 
-  void SavePublisherInfo(const std::string& publisher_info,
+  void SavePublisherInfo(
+      const base::Optional<ledger::PublisherInfo>& publisher_info,
       SavePublisherInfoCallback callback) override;
-  void LoadPublisherInfo(const std::string& filter,
+  void SavePublisherInfoList(
+      const ledger::PublisherInfoList& publisher_info_list,
+      SavePublisherInfoListCallback callback) override;
+  void LoadPublisherInfo(const ledger::PublisherInfoFilter& filter,
       LoadPublisherInfoCallback callback) override;
   void LoadPublisherInfoList(uint32_t start, uint32_t limit,
-      const std::string& filter,
+      const ledger::PublisherInfoFilter& filter,
       LoadPublisherInfoListCallback callback) override;
   void LoadMediaPublisherInfo(const std::string& media_key,
       LoadMediaPublisherInfoCallback callback) override;
@@ -61,7 +67,8 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
       OnRemoveRecurringCallback callback) override;
 
   void SetTimer(uint64_t time_offset, SetTimerCallback callback) override;
-  void OnPublisherActivity(int32_t result, const std::string& info,
+  void OnPublisherActivity(int32_t result,
+      const base::Optional<ledger::PublisherInfo>& info,
       uint64_t window_id) override;
   void OnExcludedSitesChanged(const std::string& publisher_id) override;
   void SaveContributionInfo(const std::string& probi, int32_t month,
@@ -121,6 +128,10 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
       ledger::Result result,
       std::unique_ptr<ledger::PublisherInfo> info);
 
+  static void OnSavePublisherInfoList(
+      CallbackHolder<SavePublisherInfoListCallback>* holder,
+      ledger::Result result);
+
   static void OnLoadPublisherInfo(
       CallbackHolder<LoadPublisherInfoCallback>* holder,
       ledger::Result result,
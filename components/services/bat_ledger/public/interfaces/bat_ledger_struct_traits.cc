@@ -0,0 +1,125 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/services/bat_ledger/public/interfaces/bat_ledger_struct_traits.h"
+
+namespace mojo {
+
+// static
+bool StructTraits<bat_ledger::mojom::VisitDataDataView,
+                  ledger::VisitData>::
+    Read(bat_ledger::mojom::VisitDataDataView in,
+         ledger::VisitData* out) {
+  if (!in.ReadTld(&out->tld) ||
+      !in.ReadDomain(&out->domain) ||
+      !in.ReadPath(&out->path) ||
+      !in.ReadName(&out->name) ||
+      !in.ReadUrl(&out->url) ||
+      !in.ReadProvider(&out->provider) ||
+      !in.ReadFaviconUrl(&out->favicon_url))
+    return false;
+
+  out->tab_id = in.tab_id();
+  out->local_month = static_cast<ledger::PUBLISHER_MONTH>(in.local_month());
+  out->local_year = in.local_year();
+  return true;
+}
+
+// static
+bool StructTraits<bat_ledger::mojom::TabEventDataView,
+                  ledger::TabEvent>::
+    Read(bat_ledger::mojom::TabEventDataView in,
+         ledger::TabEvent* out) {
+  if (in.type() < ledger::TAB_EVENT_TYPE::TAB_LOAD ||
+      in.type() > ledger::TAB_EVENT_TYPE::TAB_XHR_LOAD)
+    return false;
+
+  if (!in.ReadVisitData(&out->visit_data) ||
+      !in.ReadUrl(&out->url) ||
+      !in.ReadParts(&out->parts) ||
+      !in.ReadFirstPartyUrl(&out->first_party_url) ||
+      !in.ReadReferrer(&out->referrer))
+    return false;
+
+  out->type = static_cast<ledger::TAB_EVENT_TYPE>(in.type());
+  out->tab_id = in.tab_id();
+  out->current_time = in.current_time();
+  return true;
+}
+
+// static
+bool StructTraits<bat_ledger::mojom::ContributionInfoDataView,
+                  ledger::ContributionInfo>::
+    Read(bat_ledger::mojom::ContributionInfoDataView in,
+         ledger::ContributionInfo* out) {
+  if (!in.ReadPublisher(&out->publisher))
+    return false;
+
+  out->value = in.value();
+  out->date = in.date();
+  return true;
+}
+
+// static
+bool StructTraits<bat_ledger::mojom::PublisherInfoDataView,
+                  ledger::PublisherInfo>::
+    Read(bat_ledger::mojom::PublisherInfoDataView in,
+         ledger::PublisherInfo* out) {
+  if (!in.ReadId(&out->id) ||
+      !in.ReadName(&out->name) ||
+      !in.ReadUrl(&out->url) ||
+      !in.ReadProvider(&out->provider) ||
+      !in.ReadFaviconUrl(&out->favicon_url) ||
+      !in.ReadContributions(&out->contributions))
+    return false;
+
+  out->duration = in.duration();
+  out->score = in.score();
+  out->visits = in.visits();
+  out->percent = in.percent();
+  out->weight = in.weight();
+  out->excluded = static_cast<ledger::PUBLISHER_EXCLUDE>(in.excluded());
+  out->category = static_cast<ledger::PUBLISHER_CATEGORY>(in.category());
+  out->month = static_cast<ledger::PUBLISHER_MONTH>(in.month());
+  out->year = in.year();
+  out->reconcile_stamp = in.reconcile_stamp();
+  out->verified = in.verified();
+  return true;
+}
+
+// static
+bool StructTraits<bat_ledger::mojom::PublisherInfoFilterOrderDataView,
+                  std::pair<std::string, bool>>::
+    Read(bat_ledger::mojom::PublisherInfoFilterOrderDataView in,
+         std::pair<std::string, bool>* out) {
+  if (!in.ReadColumn(&out->first))
+    return false;
+
+  out->second = in.ascending();
+  return true;
+}
+
+// static
+bool StructTraits<bat_ledger::mojom::PublisherInfoFilterDataView,
+                  ledger::PublisherInfoFilter>::
+    Read(bat_ledger::mojom::PublisherInfoFilterDataView in,
+         ledger::PublisherInfoFilter* out) {
+  if (!in.ReadId(&out->id) ||
+      !in.ReadOrderBy(&out->order_by) ||
+      !in.ReadAfterId(&out->after_id))
+    return false;
+
+  out->category = in.category();
+  out->month = static_cast<ledger::PUBLISHER_MONTH>(in.month());
+  out->year = in.year();
+  out->excluded =
+      static_cast<ledger::PUBLISHER_EXCLUDE_FILTER>(in.excluded());
+  out->percent = in.percent();
+  out->min_duration = in.min_duration();
+  out->reconcile_stamp = in.reconcile_stamp();
+  out->non_verified = in.non_verified();
+  return true;
+}
+
+}  // namespace mojo
@@ -0,0 +1,272 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_PUBLIC_INTERFACES_BAT_LEDGER_STRUCT_TRAITS_H_
+#define BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_PUBLIC_INTERFACES_BAT_LEDGER_STRUCT_TRAITS_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bat/ledger/ledger.h"
+#include "bat/ledger/publisher_info.h"
+#include "brave/components/services/bat_ledger/public/interfaces/bat_ledger.mojom-shared.h"
+#include "mojo/public/cpp/bindings/struct_traits.h"
+
+namespace mojo {
+
+template <>
+struct StructTraits<bat_ledger::mojom::VisitDataDataView,
+                    ledger::VisitData> {
+  static const std::string& tld(const ledger::VisitData& data) {
+    return data.tld;
+  }
+
+  static const std::string& domain(const ledger::VisitData& data) {
+    return data.domain;
+  }
+
+  static const std::string& path(const ledger::VisitData& data) {
+    return data.path;
+  }
+
+  static uint32_t tab_id(const ledger::VisitData& data) {
+    return data.tab_id;
+  }
+
+  static int32_t local_month(const ledger::VisitData& data) {
+    return data.local_month;
+  }
+
+  static int32_t local_year(const ledger::VisitData& data) {
+    return data.local_year;
+  }
+
+  static const std::string& name(const ledger::VisitData& data) {
+    return data.name;
+  }
+
+  static const std::string& url(const ledger::VisitData& data) {
+    return data.url;
+  }
+
+  static const std::string& provider(const ledger::VisitData& data) {
+    return data.provider;
+  }
+
+  static const std::string& favicon_url(const ledger::VisitData& data) {
+    return data.favicon_url;
+  }
+
+  static bool Read(bat_ledger::mojom::VisitDataDataView in,
+                   ledger::VisitData* out);
+};
+
+template <>
+struct StructTraits<bat_ledger::mojom::TabEventDataView,
+                    ledger::TabEvent> {
+  static int32_t type(const ledger::TabEvent& event) {
+    return event.type;
+  }
+
+  static uint32_t tab_id(const ledger::TabEvent& event) {
+    return event.tab_id;
+  }
+
+  static uint64_t current_time(const ledger::TabEvent& event) {
+    return event.current_time;
+  }
+
+  static const ledger::VisitData& visit_data(const ledger::TabEvent& event) {
+    return event.visit_data;
+  }
+
+  static const std::string& url(const ledger::TabEvent& event) {
+    return event.url;
+  }
+
+  static const std::map<std::string, std::string>& parts(
+      const ledger::TabEvent& event) {
+    return event.parts;
+  }
+
+  static const std::string& first_party_url(const ledger::TabEvent& event) {
+    return event.first_party_url;
+  }
+
+  static const std::string& referrer(const ledger::TabEvent& event) {
+    return event.referrer;
+  }
+
+  static bool Read(bat_ledger::mojom::TabEventDataView in,
+                   ledger::TabEvent* out);
+};
+
+template <>
+struct StructTraits<bat_ledger::mojom::ContributionInfoDataView,
+                    ledger::ContributionInfo> {
+  static const std::string& publisher(const ledger::ContributionInfo& info) {
+    return info.publisher;
+  }
+
+  static double value(const ledger::ContributionInfo& info) {
+    return info.value;
+  }
+
+  static uint64_t date(const ledger::ContributionInfo& info) {
+    return info.date;
+  }
+
+  static bool Read(bat_ledger::mojom::ContributionInfoDataView in,
+                   ledger::ContributionInfo* out);
+};
+
+template <>
+struct StructTraits<bat_ledger::mojom::PublisherInfoDataView,
+                    ledger::PublisherInfo> {
+  static const std::string& id(const ledger::PublisherInfo& info) {
+    return info.id;
+  }
+
+  static uint64_t duration(const ledger::PublisherInfo& info) {
+    return info.duration;
+  }
+
+  static double score(const ledger::PublisherInfo& info) {
+    return info.score;
+  }
+
+  static uint32_t visits(const ledger::PublisherInfo& info) {
+    return info.visits;
+  }
+
+  static uint32_t percent(const ledger::PublisherInfo& info) {
+    return info.percent;
+  }
+
+  static double weight(const ledger::PublisherInfo& info) {
+    return info.weight;
+  }
+
+  static int32_t excluded(const ledger::PublisherInfo& info) {
+    return info.excluded;
+  }
+
+  static int32_t category(const ledger::PublisherInfo& info) {
+    return info.category;
+  }
+
+  static int32_t month(const ledger::PublisherInfo& info) {
+    return info.month;
+  }
+
+  static int32_t year(const ledger::PublisherInfo& info) {
+    return info.year;
+  }
+
+  static uint64_t reconcile_stamp(const ledger::PublisherInfo& info) {
+    return info.reconcile_stamp;
+  }
+
+  static bool verified(const ledger::PublisherInfo& info) {
+    return info.verified;
+  }
+
+  static const std::string& name(const ledger::PublisherInfo& info) {
+    return info.name;
+  }
+
+  static const std::string& url(const ledger::PublisherInfo& info) {
+    return info.url;
+  }
+
+  static const std::string& provider(const ledger::PublisherInfo& info) {
+    return info.provider;
+  }
+
+  static const std::string& favicon_url(const ledger::PublisherInfo& info) {
+    return info.favicon_url;
+  }
+
+  static const std::vector<ledger::ContributionInfo>& contributions(
+      const ledger::PublisherInfo& info) {
+    return info.contributions;
+  }
+
+  static bool Read(bat_ledger::mojom::PublisherInfoDataView in,
+                   ledger::PublisherInfo* out);
+};
+
+template <>
+struct StructTraits<bat_ledger::mojom::PublisherInfoFilterOrderDataView,
+                    std::pair<std::string, bool>> {
+  static const std::string& column(const std::pair<std::string, bool>& order) {
+    return order.first;
+  }
+
+  static bool ascending(const std::pair<std::string, bool>& order) {
+    return order.second;
+  }
+
+  static bool Read(bat_ledger::mojom::PublisherInfoFilterOrderDataView in,
+                   std::pair<std::string, bool>* out);
+};
+
+template <>
+struct StructTraits<bat_ledger::mojom::PublisherInfoFilterDataView,
+                    ledger::PublisherInfoFilter> {
+  static const std::string& id(const ledger::PublisherInfoFilter& filter) {
+    return filter.id;
+  }
+
+  static int32_t category(const ledger::PublisherInfoFilter& filter) {
+    return filter.category;
+  }
+
+  static int32_t month(const ledger::PublisherInfoFilter& filter) {
+    return filter.month;
+  }
+
+  static int32_t year(const ledger::PublisherInfoFilter& filter) {
+    return filter.year;
+  }
+
+  static int32_t excluded(const ledger::PublisherInfoFilter& filter) {
+    return filter.excluded;
+  }
+
+  static uint32_t percent(const ledger::PublisherInfoFilter& filter) {
+    return filter.percent;
+  }
+
+  static const std::vector<std::pair<std::string, bool>>& order_by(
+      const ledger::PublisherInfoFilter& filter) {
+    return filter.order_by;
+  }
+
+  static uint64_t min_duration(const ledger::PublisherInfoFilter& filter) {
+    return filter.min_duration;
+  }
+
+  static uint64_t reconcile_stamp(const ledger::PublisherInfoFilter& filter) {
+    return filter.reconcile_stamp;
+  }
+
+  static bool non_verified(const ledger::PublisherInfoFilter& filter) {
+    return filter.non_verified;
+  }
+
+  static const std::string& after_id(
+      const ledger::PublisherInfoFilter& filter) {
+    return filter.after_id;
+  }
+
+  static bool Read(bat_ledger::mojom::PublisherInfoFilterDataView in,
+                   ledger::PublisherInfoFilter* out);
+};
+
+}  // namespace mojo
+
+#endif  // BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_PUBLIC_INTERFACES_BAT_LEDGER_STRUCT_TRAITS_H_
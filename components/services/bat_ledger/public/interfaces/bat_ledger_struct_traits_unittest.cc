@@ -0,0 +1,187 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/time/time.h"
+#include "brave/components/services/bat_ledger/public/interfaces/bat_ledger.mojom.h"
+#include "mojo/public/cpp/test_support/test_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const int kBenchmarkIterations = 1000;
+const int kBenchmarkListSize = 100;
+
+ledger::PublisherInfo CreatePublisherInfo(const std::string& id) {
+  ledger::PublisherInfo info(id, ledger::PUBLISHER_MONTH::JANUARY, 2019);
+  info.duration = 120;
+  info.score = 3.5;
+  info.visits = 7;
+  info.percent = 42;
+  info.weight = 12.25;
+  info.excluded = ledger::PUBLISHER_EXCLUDE::INCLUDED;
+  info.category = ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE;
+  info.reconcile_stamp = 1546300800;
+  info.verified = true;
+  info.name = id;
+  info.url = "https://" + id + "/";
+  info.provider = "youtube";
+  info.favicon_url = "https://" + id + "/favicon.ico";
+  info.contributions.push_back(ledger::ContributionInfo(1.5, 1546300800));
+  info.contributions.back().publisher = id;
+  return info;
+}
+
+ledger::PublisherInfoList CreatePublisherInfoList() {
+  ledger::PublisherInfoList list;
+  for (int i = 0; i < kBenchmarkListSize; i++) {
+    list.push_back(CreatePublisherInfo("site" + std::to_string(i) + ".com"));
+  }
+  return list;
+}
+
+}  // namespace
+
+TEST(BatLedgerStructTraitsTest, VisitData) {
+  ledger::VisitData input("brave.com", "brave.com", "/path", 5,
+      ledger::PUBLISHER_MONTH::MARCH, 2019, "Brave", "https://brave.com/",
+      "youtube", "https://brave.com/favicon.ico");
+
+  ledger::VisitData output;
+  ASSERT_TRUE(mojo::test::SerializeAndDeserialize<bat_ledger::mojom::VisitData>(
+      &input, &output));
+  EXPECT_EQ(output.tld, input.tld);
+  EXPECT_EQ(output.domain, input.domain);
+  EXPECT_EQ(output.path, input.path);
+  EXPECT_EQ(output.tab_id, input.tab_id);
+  EXPECT_EQ(output.local_month, input.local_month);
+  EXPECT_EQ(output.local_year, input.local_year);
+  EXPECT_EQ(output.name, input.name);
+  EXPECT_EQ(output.url, input.url);
+  EXPECT_EQ(output.provider, input.provider);
+  EXPECT_EQ(output.favicon_url, input.favicon_url);
+}
+
+TEST(BatLedgerStructTraitsTest, TabEvent) {
+  ledger::TabEvent input(ledger::TAB_EVENT_TYPE::TAB_XHR_LOAD, 5, 1546300800);
+  input.visit_data.path = "https://www.youtube.com/api/stats/watchtime";
+  input.url = "https://www.youtube.com/api/stats/watchtime";
+  input.parts["docid"] = "abc";
+  input.first_party_url = "https://www.youtube.com/";
+  input.referrer = "https://www.youtube.com/";
+
+  ledger::TabEvent output;
+  ASSERT_TRUE(mojo::test::SerializeAndDeserialize<bat_ledger::mojom::TabEvent>(
+      &input, &output));
+  EXPECT_EQ(output.type, input.type);
+  EXPECT_EQ(output.tab_id, input.tab_id);
+  EXPECT_EQ(output.current_time, input.current_time);
+  EXPECT_EQ(output.visit_data.path, input.visit_data.path);
+  EXPECT_EQ(output.url, input.url);
+  EXPECT_EQ(output.parts, input.parts);
+  EXPECT_EQ(output.first_party_url, input.first_party_url);
+  EXPECT_EQ(output.referrer, input.referrer);
+}
+
+TEST(BatLedgerStructTraitsTest, PublisherInfo) {
+  ledger::PublisherInfo input = CreatePublisherInfo("brave.com");
+
+  ledger::PublisherInfo output;
+  ASSERT_TRUE(
+      mojo::test::SerializeAndDeserialize<bat_ledger::mojom::PublisherInfo>(
+          &input, &output));
+  EXPECT_EQ(output.id, input.id);
+  EXPECT_EQ(output.duration, input.duration);
+  EXPECT_EQ(output.score, input.score);
+  EXPECT_EQ(output.visits, input.visits);
+  EXPECT_EQ(output.percent, input.percent);
+  EXPECT_EQ(output.weight, input.weight);
+  EXPECT_EQ(output.excluded, input.excluded);
+  EXPECT_EQ(output.category, input.category);
+  EXPECT_EQ(output.month, input.month);
+  EXPECT_EQ(output.year, input.year);
+  EXPECT_EQ(output.reconcile_stamp, input.reconcile_stamp);
+  EXPECT_EQ(output.verified, input.verified);
+  EXPECT_EQ(output.name, input.name);
+  EXPECT_EQ(output.url, input.url);
+  EXPECT_EQ(output.provider, input.provider);
+  EXPECT_EQ(output.favicon_url, input.favicon_url);
+  ASSERT_EQ(output.contributions.size(), 1u);
+  EXPECT_EQ(output.contributions[0].publisher, "brave.com");
+  EXPECT_EQ(output.contributions[0].value, 1.5);
+  EXPECT_EQ(output.contributions[0].date, 1546300800u);
+}
+
+TEST(BatLedgerStructTraitsTest, PublisherInfoFilter) {
+  ledger::PublisherInfoFilter input;
+  input.id = "brave.com";
+  input.category = ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE;
+  input.month = ledger::PUBLISHER_MONTH::ANY;
+  input.year = -1;
+  input.excluded =
+      ledger::PUBLISHER_EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED;
+  input.percent = 1;
+  input.order_by.push_back(std::make_pair("ai.percent", false));
+  input.order_by.push_back(std::make_pair("ai.publisher_id", true));
+  input.min_duration = 8;
+  input.reconcile_stamp = 1546300800;
+  input.non_verified = true;
+  input.after_id = "example.com";
+
+  ledger::PublisherInfoFilter output;
+  ASSERT_TRUE(mojo::test::SerializeAndDeserialize<
+      bat_ledger::mojom::PublisherInfoFilter>(&input, &output));
+  EXPECT_EQ(output.id, input.id);
+  EXPECT_EQ(output.category, input.category);
+  EXPECT_EQ(output.month, input.month);
+  EXPECT_EQ(output.year, input.year);
+  EXPECT_EQ(output.excluded, input.excluded);
+  EXPECT_EQ(output.percent, input.percent);
+  EXPECT_EQ(output.order_by, input.order_by);
+  EXPECT_EQ(output.min_duration, input.min_duration);
+  EXPECT_EQ(output.reconcile_stamp, input.reconcile_stamp);
+  EXPECT_EQ(output.non_verified, input.non_verified);
+  EXPECT_EQ(output.after_id, input.after_id);
+}
+
+// Compares the cost of passing a publisher list as JSON strings, as the
+// interface used to, with serializing the mojom structs. Run with
+// --gtest_also_run_disabled_tests.
+TEST(BatLedgerStructTraitsTest, DISABLED_PublisherInfoListBenchmark) {
+  ledger::PublisherInfoList input = CreatePublisherInfoList();
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kBenchmarkIterations; i++) {
+    ledger::PublisherInfoList output;
+    for (const auto& info : input) {
+      ledger::PublisherInfo copy;
+      ASSERT_TRUE(copy.loadFromJson(info.ToJson()));
+      output.push_back(copy);
+    }
+    ASSERT_EQ(output.size(), input.size());
+  }
+  const base::TimeDelta json_time = base::TimeTicks::Now() - start;
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kBenchmarkIterations; i++) {
+    ledger::PublisherInfoList output;
+    for (auto& info : input) {
+      ledger::PublisherInfo copy;
+      ASSERT_TRUE(
+          mojo::test::SerializeAndDeserialize<bat_ledger::mojom::PublisherInfo>(
+              &info, &copy));
+      output.push_back(copy);
+    }
+    ASSERT_EQ(output.size(), input.size());
+  }
+  const base::TimeDelta mojo_time = base::TimeTicks::Now() - start;
+
+  LOG(INFO) << kBenchmarkIterations << " round trips of "
+            << kBenchmarkListSize << " publishers: json "
+            << json_time.InMilliseconds() << "ms, mojom "
+            << mojo_time.InMilliseconds() << "ms";
+}